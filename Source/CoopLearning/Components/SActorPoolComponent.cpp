@@ -0,0 +1,163 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "SActorPoolComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "SPoolableActor.h"
+#include "CoopLearning.h"
+#include "HAL/PlatformTime.h"
+#include "SHotPathStats.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Actor Pool Hits"), STAT_ActorPoolHits, STATGROUP_CoopLearning);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Actor Pool Misses"), STAT_ActorPoolMisses, STATGROUP_CoopLearning);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Actor Pool Spawn Ms Saved"), STAT_ActorPoolMsSaved, STATGROUP_CoopLearning);
+
+USActorPoolComponent::USActorPoolComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	Hits = 0;
+	Misses = 0;
+	SpawnSeconds = 0;
+	SpawnCount = 0;
+}
+
+AActor* USActorPoolComponent::SpawnPooledActor(UClass* Class, const FTransform& Transform, AActor* NewOwner)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Owner = NewOwner;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	double StartTime = FPlatformTime::Seconds();
+
+	AActor* Actor = GetWorld()->SpawnActor<AActor>(Class, Transform, SpawnParams);
+	FSHotPathStats::AddCount(ESHotPathCounter::ActorsSpawned);
+
+	SpawnSeconds += FPlatformTime::Seconds() - StartTime;
+	SpawnCount++;
+
+	return Actor;
+}
+
+void USActorPoolComponent::Prewarm()
+{
+	for (const TPair<TSubclassOf<AActor>, int32>& Entry : PrewarmCounts)
+	{
+		if (!Entry.Key)
+		{
+			continue;
+		}
+
+		FSActorPoolBucket& Bucket = Buckets.FindOrAdd(*Entry.Key);
+
+		for (int32 i = Bucket.Free.Num(); i < Entry.Value; i++)
+		{
+			//Owned by the pool until released, which clears the owner again
+			AActor* Actor = SpawnPooledActor(*Entry.Key, GetOwner()->GetActorTransform(), GetOwner());
+
+			if (Actor)
+			{
+				Release(Actor);
+			}
+		}
+	}
+}
+
+AActor* USActorPoolComponent::Acquire(UClass* Class, const FTransform& Transform, AActor* NewOwner)
+{
+	if (!Class)
+	{
+		return nullptr;
+	}
+
+	AActor* Actor = nullptr;
+	FSActorPoolBucket* Bucket = Buckets.Find(Class);
+
+	//Released actors can still get destroyed by level transitions, skip those
+	while (Bucket && Bucket->Free.Num() > 0 && !Actor)
+	{
+		Actor = Bucket->Free.Pop(false);
+
+		if (Actor && Actor->IsPendingKillPending())
+		{
+			Actor = nullptr;
+		}
+	}
+
+	if (!Actor)
+	{
+		Misses++;
+		INC_DWORD_STAT(STAT_ActorPoolMisses);
+
+		Actor = SpawnPooledActor(Class, Transform, NewOwner);
+
+		if (!Actor)
+		{
+			return nullptr;
+		}
+	}
+	else
+	{
+		Hits++;
+		INC_DWORD_STAT(STAT_ActorPoolHits);
+		INC_FLOAT_STAT_BY(STAT_ActorPoolMsSaved, SpawnCount > 0 ? (float)(SpawnSeconds / SpawnCount * 1000.0) : 0.0f);
+
+		Actor->SetNetDormancy(DORM_Awake);
+		Actor->SetOwner(NewOwner);
+		Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+		Actor->SetActorHiddenInGame(false);
+		Actor->SetActorEnableCollision(true);
+		Actor->SetActorTickEnabled(true);
+	}
+
+	if (ISPoolableActor* Poolable = Cast<ISPoolableActor>(Actor))
+	{
+		Poolable->OnAcquiredFromPool();
+	}
+
+	return Actor;
+}
+
+void USActorPoolComponent::Release(AActor* Actor)
+{
+	if (!Actor || Actor->IsPendingKillPending())
+	{
+		return;
+	}
+
+	Deactivate(Actor);
+
+	FSActorPoolBucket& Bucket = Buckets.FindOrAdd(Actor->GetClass());
+	Bucket.Free.AddUnique(Actor);
+}
+
+void USActorPoolComponent::Deactivate(AActor* Actor)
+{
+	if (ISPoolableActor* Poolable = Cast<ISPoolableActor>(Actor))
+	{
+		Poolable->OnReleasedToPool();
+	}
+
+	Actor->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	Actor->SetOwner(nullptr);
+	Actor->SetActorHiddenInGame(true);
+	Actor->SetActorEnableCollision(false);
+	Actor->SetActorTickEnabled(false);
+
+	//The channel sends the hidden state once more before it closes
+	Actor->SetNetDormancy(DORM_DormantAll);
+}
+
+void USActorPoolComponent::DumpStats() const
+{
+	int32 Requests = Hits + Misses;
+	float HitRate = Requests > 0 ? (float)Hits / Requests * 100.0f : 0.0f;
+	double AverageSpawnMs = SpawnCount > 0 ? SpawnSeconds / SpawnCount * 1000.0 : 0.0;
+
+	UE_LOG(LogTemp, Log, TEXT("ActorPool: %d requests, %d hits, %d misses, %.1f%% hit rate"), Requests, Hits, Misses, HitRate);
+	UE_LOG(LogTemp, Log, TEXT("ActorPool: %.3f ms average spawn, about %.2f ms of spawning saved"), AverageSpawnMs, AverageSpawnMs * Hits);
+
+	for (const TPair<UClass*, FSActorPoolBucket>& Entry : Buckets)
+	{
+		UE_LOG(LogTemp, Log, TEXT("ActorPool: %s %d free"), *GetNameSafe(Entry.Key), Entry.Value.Free.Num());
+	}
+}
@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "SActorPoolComponent.generated.h"
+
+USTRUCT()
+struct FSActorPoolBucket
+{
+	GENERATED_BODY()
+
+	//Released actors ready for reuse
+	UPROPERTY()
+	TArray<AActor*> Free;
+};
+
+UCLASS( ClassGroup=(COOP), meta=(BlueprintSpawnableComponent) )
+class COOPLEARNING_API USActorPoolComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:	
+	// Sets default values for this component's properties
+	USActorPoolComponent();
+
+protected:
+
+	//Instances spawned per class by Prewarm
+	UPROPERTY(EditDefaultsOnly, Category = "ActorPool")
+	TMap<TSubclassOf<AActor>, int32> PrewarmCounts;
+
+	UPROPERTY()
+	TMap<UClass*, FSActorPoolBucket> Buckets;
+
+	int32 Hits;
+
+	int32 Misses;
+
+	//Time spent in SpawnActor for pool misses and prewarming, used to estimate what hits saved
+	double SpawnSeconds;
+
+	int32 SpawnCount;
+
+	//Owner is set before BeginPlay, so pooled actors don't mistake themselves for level placed ones there
+	AActor* SpawnPooledActor(UClass* Class, const FTransform& Transform, AActor* NewOwner);
+
+	void Deactivate(AActor* Actor);
+
+public:
+
+	//Spawns every PrewarmCounts entry into the pool
+	void Prewarm();
+
+	//Reuses a released actor of exactly Class or spawns a new one, server only. Either way OnAcquiredFromPool runs
+	AActor* Acquire(UClass* Class, const FTransform& Transform, AActor* NewOwner = nullptr);
+
+	template<typename T>
+	T* Acquire(TSubclassOf<T> Class, const FTransform& Transform, AActor* NewOwner = nullptr)
+	{
+		return Cast<T>(Acquire(*Class, Transform, NewOwner));
+	}
+
+	//Hands an actor back for reuse, it is hidden, stops ticking and goes dormant
+	void Release(AActor* Actor);
+
+	void DumpStats() const;
+};
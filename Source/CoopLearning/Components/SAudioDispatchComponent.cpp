@@ -0,0 +1,170 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "SAudioDispatchComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Sound/SoundBase.h"
+#include "Sound/SoundAttenuation.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "SGameState.h"
+#include "CoopLearning.h"
+#include "SHotPathStats.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Sounds Played"), STAT_SoundsPlayed, STATGROUP_CoopLearning);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Sounds Coalesced"), STAT_SoundsCoalesced, STATGROUP_CoopLearning);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Sounds Over Voice Limit"), STAT_SoundsOverLimit, STATGROUP_CoopLearning);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Sounds Out Of Range"), STAT_SoundsOutOfRange, STATGROUP_CoopLearning);
+
+USAudioDispatchComponent::USAudioDispatchComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	CoalesceWindow = 0.05f;
+
+	ConcurrencyLimits.Add(ESSoundCategory::Weapon, 16);
+	ConcurrencyLimits.Add(ESSoundCategory::Explosion, 6);
+	ConcurrencyLimits.Add(ESSoundCategory::Character, 8);
+	ConcurrencyLimits.Add(ESSoundCategory::Misc, 8);
+
+	ListenerFrame = MAX_uint64;
+	bHasListener = false;
+}
+
+bool USAudioDispatchComponent::IsCoalesced(USoundBase* Sound, const AActor* Source, float Now)
+{
+	RecentSounds.RemoveAllSwap([this, Now](const FSRecentSound& Recent)
+	{
+		return Now - Recent.Time > CoalesceWindow;
+	}, false);
+
+	for (const FSRecentSound& Recent : RecentSounds)
+	{
+		if (Recent.Sound == Sound && Recent.Source == Source)
+		{
+			return true;
+		}
+	}
+
+	FSRecentSound Recent;
+	Recent.Sound = Sound;
+	Recent.Source = Source;
+	Recent.Time = Now;
+	RecentSounds.Add(Recent);
+
+	return false;
+}
+
+bool USAudioDispatchComponent::IsOutOfRange(USoundBase* Sound, const FVector& Location, USoundAttenuation* Attenuation)
+{
+	if (ListenerFrame != GFrameCounter)
+	{
+		ListenerFrame = GFrameCounter;
+
+		APlayerController* PC = GetWorld()->GetFirstPlayerController();
+		bHasListener = PC != nullptr;
+
+		if (bHasListener)
+		{
+			FVector FrontDir;
+			FVector RightDir;
+			PC->GetAudioListenerPosition(ListenerLocation, FrontDir, RightDir);
+		}
+	}
+
+	if (!bHasListener)
+	{
+		return false;
+	}
+
+	float MaxDistance = WORLD_MAX;
+
+	if (Attenuation)
+	{
+		if (Attenuation->Attenuation.bAttenuate)
+		{
+			MaxDistance = Attenuation->Attenuation.GetMaxDimension();
+		}
+	}
+	else
+	{
+		MaxDistance = Sound->GetMaxDistance();
+	}
+
+	return FVector::DistSquared(ListenerLocation, Location) > FMath::Square(MaxDistance);
+}
+
+bool USAudioDispatchComponent::HasFreeVoice(ESSoundCategory Category, float Now)
+{
+	const int32* Limit = ConcurrencyLimits.Find(Category);
+
+	if (!Limit)
+	{
+		return true;
+	}
+
+	TArray<float>& EndTimes = VoiceEndTimes.FindOrAdd(Category);
+
+	EndTimes.RemoveAllSwap([Now](float EndTime)
+	{
+		return EndTime <= Now;
+	}, false);
+
+	return EndTimes.Num() < *Limit;
+}
+
+void USAudioDispatchComponent::PlaySound(USoundBase* Sound, const FVector& Location, const AActor* Source, ESSoundCategory Category, USoundAttenuation* Attenuation)
+{
+	if (!Sound || GetNetMode() == NM_DedicatedServer)
+	{
+		return;
+	}
+
+	float Now = GetWorld()->GetTimeSeconds();
+
+	if (IsOutOfRange(Sound, Location, Attenuation))
+	{
+		INC_DWORD_STAT(STAT_SoundsOutOfRange);
+		return;
+	}
+
+	if (!HasFreeVoice(Category, Now))
+	{
+		INC_DWORD_STAT(STAT_SoundsOverLimit);
+		return;
+	}
+
+	if (IsCoalesced(Sound, Source, Now))
+	{
+		INC_DWORD_STAT(STAT_SoundsCoalesced);
+		return;
+	}
+
+	UGameplayStatics::PlaySoundAtLocation(this, Sound, Location, 1, 1, 0, Attenuation);
+
+	INC_DWORD_STAT(STAT_SoundsPlayed);
+
+	if (ConcurrencyLimits.Contains(Category))
+	{
+		VoiceEndTimes.FindOrAdd(Category).Add(Now + Sound->GetDuration());
+	}
+}
+
+void USAudioDispatchComponent::PlaySoundAtLocation(const AActor* Source, USoundBase* Sound, const FVector& Location, ESSoundCategory Category, USoundAttenuation* Attenuation)
+{
+	COOP_HOT_PATH_SCOPE(SoundDispatch);
+
+	if (!Source)
+	{
+		return;
+	}
+
+	ASGameState* GS = Source->GetWorld()->GetGameState<ASGameState>();
+
+	if (GS)
+	{
+		GS->GetAudioDispatch()->PlaySound(Sound, Location, Source, Category, Attenuation);
+	}
+	else
+	{
+		UGameplayStatics::PlaySoundAtLocation(Source, Sound, Location, 1, 1, 0, Attenuation);
+	}
+}
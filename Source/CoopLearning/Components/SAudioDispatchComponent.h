@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "SAudioDispatchComponent.generated.h"
+
+class USoundBase;
+class USoundAttenuation;
+
+UENUM(BlueprintType)
+enum class ESSoundCategory : uint8
+{
+	Weapon,
+	Explosion,
+	Character,
+	Misc
+};
+
+struct FSRecentSound
+{
+	USoundBase* Sound;
+
+	TWeakObjectPtr<const AActor> Source;
+
+	float Time;
+};
+
+UCLASS( ClassGroup=(COOP), meta=(BlueprintSpawnableComponent) )
+class COOPLEARNING_API USAudioDispatchComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:	
+	// Sets default values for this component's properties
+	USAudioDispatchComponent();
+
+protected:
+
+	//The same cue from the same source within this many seconds plays once
+	UPROPERTY(EditDefaultsOnly, Category = "Audio")
+	float CoalesceWindow;
+
+	//Voices playing at once per category, requests over the limit are dropped
+	UPROPERTY(EditDefaultsOnly, Category = "Audio")
+	TMap<ESSoundCategory, int32> ConcurrencyLimits;
+
+	TArray<FSRecentSound> RecentSounds;
+
+	//When each voice playing in a category ends. Sounds are fire and forget, so this is tracked from their duration instead of an audio component
+	TMap<ESSoundCategory, TArray<float>> VoiceEndTimes;
+
+	uint64 ListenerFrame;
+
+	FVector ListenerLocation;
+
+	bool bHasListener;
+
+	bool IsCoalesced(USoundBase* Sound, const AActor* Source, float Now);
+
+	bool IsOutOfRange(USoundBase* Sound, const FVector& Location, USoundAttenuation* Attenuation);
+
+	bool HasFreeVoice(ESSoundCategory Category, float Now);
+
+public:
+
+	void PlaySound(USoundBase* Sound, const FVector& Location, const AActor* Source, ESSoundCategory Category, USoundAttenuation* Attenuation);
+
+	//Routes through the GameStates dispatcher, plays directly when there is none
+	static void PlaySoundAtLocation(const AActor* Source, USoundBase* Sound, const FVector& Location, ESSoundCategory Category, USoundAttenuation* Attenuation);
+};
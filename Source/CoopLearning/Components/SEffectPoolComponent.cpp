@@ -0,0 +1,219 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "SEffectPoolComponent.h"
+#include "Components/DecalComponent.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Materials/MaterialInterface.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/World.h"
+#include "CoopLearning.h"
+#include "SHotPathStats.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Effect Pool Hits"), STAT_EffectPoolHits, STATGROUP_CoopLearning);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Effect Pool Misses"), STAT_EffectPoolMisses, STATGROUP_CoopLearning);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Effect Pool Evicted"), STAT_EffectPoolEvicted, STATGROUP_CoopLearning);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Effect Pool Over Budget"), STAT_EffectPoolOverBudget, STATGROUP_CoopLearning);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Effect Pool Distance Culled"), STAT_EffectPoolCulled, STATGROUP_CoopLearning);
+
+USEffectPoolComponent::USEffectPoolComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickInterval = 0.25f;
+
+	DecalCapacity = 64;
+	TracerCapacity = 48;
+	ImpactCapacity = 48;
+	MaxSpawnsPerFrame = 32;
+	ImpactCullDistance = 6000;
+	TracerCullDistance = 10000;
+
+	BudgetFrame = MAX_uint64;
+	SpawnsThisFrame = 0;
+	CameraFrame = MAX_uint64;
+	bHasCamera = false;
+}
+
+void USEffectPoolComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	Decals.Capacity = DecalCapacity;
+	Tracers.Capacity = TracerCapacity;
+	Impacts.Capacity = ImpactCapacity;
+
+	//Nobody looks at effects on a dedicated server
+	if (GetNetMode() == NM_DedicatedServer)
+	{
+		SetComponentTickEnabled(false);
+	}
+}
+
+void USEffectPoolComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	float Now = GetWorld()->GetTimeSeconds();
+
+	for (int32 i = 0; i < Decals.Slots.Num(); i++)
+	{
+		if (Decals.ExpireTimes[i] <= Now && Decals.Slots[i]->IsVisible())
+		{
+			Decals.Slots[i]->SetVisibility(false);
+		}
+	}
+}
+
+bool USEffectPoolComponent::ShouldSpawn(const FVector& Location, float CullDistance)
+{
+	if (GetNetMode() == NM_DedicatedServer)
+	{
+		return false;
+	}
+
+	if (BudgetFrame != GFrameCounter)
+	{
+		BudgetFrame = GFrameCounter;
+		SpawnsThisFrame = 0;
+	}
+
+	if (SpawnsThisFrame >= MaxSpawnsPerFrame)
+	{
+		INC_DWORD_STAT(STAT_EffectPoolOverBudget);
+		return false;
+	}
+
+	if (CameraFrame != GFrameCounter)
+	{
+		CameraFrame = GFrameCounter;
+
+		APlayerController* PC = GetWorld()->GetFirstPlayerController();
+		bHasCamera = PC && PC->PlayerCameraManager;
+
+		if (bHasCamera)
+		{
+			CameraLocation = PC->PlayerCameraManager->GetCameraLocation();
+		}
+	}
+
+	if (bHasCamera && FVector::DistSquared(CameraLocation, Location) > FMath::Square(CullDistance))
+	{
+		INC_DWORD_STAT(STAT_EffectPoolCulled);
+		return false;
+	}
+
+	SpawnsThisFrame++;
+	return true;
+}
+
+int32 USEffectPoolComponent::ClaimSlot(FSEffectRing& Ring)
+{
+	int32 Index = Ring.Next;
+	Ring.Next = (Ring.Next + 1) % Ring.Capacity;
+
+	if (Index >= Ring.Slots.Num())
+	{
+		INC_DWORD_STAT(STAT_EffectPoolMisses);
+		return Ring.Slots.Num();
+	}
+
+	USceneComponent* Slot = Ring.Slots[Index];
+	UParticleSystemComponent* Particle = Cast<UParticleSystemComponent>(Slot);
+
+	bool bInUse = Particle ? Particle->IsActive() : Slot->IsVisible();
+
+	if (bInUse)
+	{
+		INC_DWORD_STAT(STAT_EffectPoolEvicted);
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_EffectPoolHits);
+	}
+
+	return Index;
+}
+
+void USEffectPoolComponent::SpawnDecal(UMaterialInterface* Material, const FVector& Size, const FVector& Location, const FRotator& Rotation, float LifeTime)
+{
+	COOP_HOT_PATH_SCOPE(EffectSpawns);
+
+	if (!Material || !ShouldSpawn(Location, ImpactCullDistance))
+	{
+		return;
+	}
+
+	FSHotPathStats::AddCount(ESHotPathCounter::EffectsSpawned);
+
+	int32 Index = ClaimSlot(Decals);
+
+	if (Index == Decals.Slots.Num())
+	{
+		UDecalComponent* NewDecal = NewObject<UDecalComponent>(GetOwner());
+		NewDecal->SetFadeScreenSize(0.001f);
+		NewDecal->RegisterComponent();
+
+		Decals.Slots.Add(NewDecal);
+		Decals.ExpireTimes.Add(0);
+	}
+
+	UDecalComponent* Decal = CastChecked<UDecalComponent>(Decals.Slots[Index]);
+	Decal->DecalSize = Size;
+	Decal->SetDecalMaterial(Material);
+	Decal->SetWorldLocationAndRotation(Location, Rotation);
+	Decal->SetVisibility(true);
+
+	//Zero lifetime keeps the decal until its slot is recycled, like SpawnDecalAtLocation
+	Decals.ExpireTimes[Index] = LifeTime > 0 ? GetWorld()->GetTimeSeconds() + LifeTime : TNumericLimits<float>::Max();
+}
+
+UParticleSystemComponent* USEffectPoolComponent::SpawnParticle(FSEffectRing& Ring, UParticleSystem* Template, const FVector& Location, const FRotator& Rotation)
+{
+	COOP_HOT_PATH_SCOPE(EffectSpawns);
+	FSHotPathStats::AddCount(ESHotPathCounter::EffectsSpawned);
+
+	int32 Index = ClaimSlot(Ring);
+
+	if (Index == Ring.Slots.Num())
+	{
+		UParticleSystemComponent* NewParticle = NewObject<UParticleSystemComponent>(GetOwner());
+		NewParticle->bAutoActivate = false;
+		NewParticle->bAutoDestroy = false;
+		NewParticle->SetTemplate(Template);
+		NewParticle->RegisterComponent();
+
+		Ring.Slots.Add(NewParticle);
+	}
+
+	UParticleSystemComponent* Particle = CastChecked<UParticleSystemComponent>(Ring.Slots[Index]);
+
+	if (Particle->Template != Template)
+	{
+		Particle->SetTemplate(Template);
+	}
+
+	Particle->SetWorldLocationAndRotation(Location, Rotation);
+	Particle->Activate(true);
+
+	return Particle;
+}
+
+UParticleSystemComponent* USEffectPoolComponent::SpawnTracer(UParticleSystem* Template, const FVector& Location)
+{
+	if (!Template || !ShouldSpawn(Location, TracerCullDistance))
+	{
+		return nullptr;
+	}
+
+	return SpawnParticle(Tracers, Template, Location, FRotator::ZeroRotator);
+}
+
+void USEffectPoolComponent::SpawnImpact(UParticleSystem* Template, const FVector& Location, const FRotator& Rotation)
+{
+	if (!Template || !ShouldSpawn(Location, ImpactCullDistance))
+	{
+		return;
+	}
+
+	SpawnParticle(Impacts, Template, Location, Rotation);
+}
@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "SEffectPoolComponent.generated.h"
+
+class USceneComponent;
+class UDecalComponent;
+class UParticleSystem;
+class UParticleSystemComponent;
+class UMaterialInterface;
+
+//Fixed capacity ring of effect components, once full the oldest entry is recycled
+USTRUCT()
+struct FSEffectRing
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<USceneComponent*> Slots;
+
+	//Only used by decals, particles finish on their own
+	TArray<float> ExpireTimes;
+
+	int32 Capacity = 0;
+
+	int32 Next = 0;
+};
+
+UCLASS( ClassGroup=(COOP), meta=(BlueprintSpawnableComponent) )
+class COOPLEARNING_API USEffectPoolComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:	
+	// Sets default values for this component's properties
+	USEffectPoolComponent();
+
+protected:
+
+	virtual void BeginPlay() override;
+
+	UPROPERTY(EditDefaultsOnly, Category = "EffectPool", meta = (ClampMin = 1))
+	int32 DecalCapacity;
+
+	UPROPERTY(EditDefaultsOnly, Category = "EffectPool", meta = (ClampMin = 1))
+	int32 TracerCapacity;
+
+	UPROPERTY(EditDefaultsOnly, Category = "EffectPool", meta = (ClampMin = 1))
+	int32 ImpactCapacity;
+
+	//Effects started per frame across all rings, the rest of the frame is dropped
+	UPROPERTY(EditDefaultsOnly, Category = "EffectPool", meta = (ClampMin = 1))
+	int32 MaxSpawnsPerFrame;
+
+	//Impacts and decals further than this from the local camera are skipped
+	UPROPERTY(EditDefaultsOnly, Category = "EffectPool")
+	float ImpactCullDistance;
+
+	//Tracers starting further than this from the local camera are skipped
+	UPROPERTY(EditDefaultsOnly, Category = "EffectPool")
+	float TracerCullDistance;
+
+	UPROPERTY()
+	FSEffectRing Decals;
+
+	UPROPERTY()
+	FSEffectRing Tracers;
+
+	UPROPERTY()
+	FSEffectRing Impacts;
+
+	uint64 BudgetFrame;
+
+	int32 SpawnsThisFrame;
+
+	uint64 CameraFrame;
+
+	FVector CameraLocation;
+
+	bool bHasCamera;
+
+	//Budget and distance check, false if the effect should be skipped
+	bool ShouldSpawn(const FVector& Location, float CullDistance);
+
+	//Index of the slot to (re)use, equal to Slots.Num() when a new component has to be created
+	int32 ClaimSlot(FSEffectRing& Ring);
+
+	UParticleSystemComponent* SpawnParticle(FSEffectRing& Ring, UParticleSystem* Template, const FVector& Location, const FRotator& Rotation);
+
+public:
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	void SpawnDecal(UMaterialInterface* Material, const FVector& Size, const FVector& Location, const FRotator& Rotation, float LifeTime);
+
+	//Returned so the caller can set its target parameter, null if culled
+	UParticleSystemComponent* SpawnTracer(UParticleSystem* Template, const FVector& Location);
+
+	void SpawnImpact(UParticleSystem* Template, const FVector& Location, const FRotator& Rotation);
+};
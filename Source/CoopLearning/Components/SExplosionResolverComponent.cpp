@@ -0,0 +1,277 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "SExplosionResolverComponent.h"
+#include "Engine/World.h"
+#include "Engine/EngineTypes.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/DamageType.h"
+#include "GameFramework/MovementComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Async/ParallelFor.h"
+#include "CoopLearning.h"
+#include "SExplosive.h"
+#include "SCombatEventRecorder.h"
+#include "SHotPathStats.h"
+
+static int32 ParallelExplosionTraceThreshold = 8;
+
+FAutoConsoleVariableRef CVARParallelExplosionTraceThreshold (TEXT("ExplosionParallelTraceThreshold"), ParallelExplosionTraceThreshold, TEXT("Minimum components in an explosion before its visibility traces are spread over worker threads"), ECVF_Default);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Explosions Resolved"), STAT_ExplosionsResolved, STATGROUP_CoopLearning);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Explosion Visibility Traces"), STAT_ExplosionTraces, STATGROUP_CoopLearning);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Explosions Deferred"), STAT_ExplosionsDeferred, STATGROUP_CoopLearning);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Explosion Cue Batches"), STAT_ExplosionCueBatches, STATGROUP_CoopLearning);
+
+void FSExplosion::SetImpulseFrom(const URadialForceComponent* RadialForceComp)
+{
+	Radius = RadialForceComp->Radius;
+	ImpulseStrength = RadialForceComp->ImpulseStrength;
+	ImpulseFalloff = RadialForceComp->Falloff;
+	bImpulseVelChange = RadialForceComp->bImpulseVelChange;
+}
+
+USExplosionResolverComponent::USExplosionResolverComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+
+	SetIsReplicated(true);
+
+	SecondaryExplosionDelay = 0.1f;
+	MaxExplosionsPerTick = 4;
+
+	bResolving = false;
+	BudgetFrame = 0;
+	ResolvedThisFrame = 0;
+}
+
+void USExplosionResolverComponent::Explode(const FSExplosion& Explosion)
+{
+	FSExplosion Pending = Explosion;
+	Pending.DueTime = GetWorld()->GetTimeSeconds();
+
+	//Set off by the explosion being resolved, a barrel in a cluster
+	if (bResolving)
+	{
+		Pending.DueTime += SecondaryExplosionDelay;
+		INC_DWORD_STAT(STAT_ExplosionsDeferred);
+	}
+
+	int32 InsertIndex = PendingExplosions.Num();
+	while (InsertIndex > 0 && PendingExplosions[InsertIndex - 1].DueTime > Pending.DueTime)
+	{
+		InsertIndex--;
+	}
+
+	PendingExplosions.Insert(Pending, InsertIndex);
+
+	if (!bResolving)
+	{
+		ProcessPending();
+	}
+
+	UpdateTickEnabled();
+}
+
+void USExplosionResolverComponent::ProcessPending()
+{
+	if (BudgetFrame != GFrameCounter)
+	{
+		BudgetFrame = GFrameCounter;
+		ResolvedThisFrame = 0;
+	}
+
+	float Now = GetWorld()->GetTimeSeconds();
+
+	bResolving = true;
+
+	while (PendingExplosions.Num() > 0 && PendingExplosions[0].DueTime <= Now && ResolvedThisFrame < MaxExplosionsPerTick)
+	{
+		FSExplosion Explosion = PendingExplosions[0];
+		PendingExplosions.RemoveAt(0, 1, false);
+		ResolvedThisFrame++;
+
+		Resolve(Explosion);
+	}
+
+	bResolving = false;
+}
+
+void USExplosionResolverComponent::QueueExplosionCue(AActor* Source, const FVector& Location)
+{
+	FSExplosionCue& Cue = PendingCues.AddDefaulted_GetRef();
+	Cue.Source = Source;
+	Cue.Location = Location;
+
+	UpdateTickEnabled();
+}
+
+void USExplosionResolverComponent::UpdateTickEnabled()
+{
+	SetComponentTickEnabled(PendingExplosions.Num() > 0 || PendingCues.Num() > 0);
+}
+
+void USExplosionResolverComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (PendingExplosions.Num() > 0)
+	{
+		ProcessPending();
+	}
+
+	if (PendingCues.Num() > 0)
+	{
+		INC_DWORD_STAT(STAT_ExplosionCueBatches);
+
+		MulticastExplosionCues(PendingCues);
+		FSHotPathStats::AddCount(ESHotPathCounter::GameStateRPCs);
+		PendingCues.Reset();
+	}
+
+	UpdateTickEnabled();
+}
+
+void USExplosionResolverComponent::MulticastExplosionCues_Implementation(const TArray<FSExplosionCue>& Cues)
+{
+	for (const FSExplosionCue& Cue : Cues)
+	{
+		ISExplosive* Explosive = Cast<ISExplosive>(Cue.Source);
+
+		if (Explosive)
+		{
+			Explosive->PlayExplosionEffects(Cue.Location);
+		}
+	}
+}
+
+void USExplosionResolverComponent::TraceVisibility(const FSExplosion& Explosion, const FCollisionQueryParams& QueryParams)
+{
+	UWorld* World = GetWorld();
+
+	INC_DWORD_STAT_BY(STAT_ExplosionTraces, Targets.Num());
+	FSHotPathStats::AddCount(ESHotPathCounter::Traces, Targets.Num());
+
+	//Same rule as ComponentIsDamageableFrom, visible if nothing or the component itself blocks the line to its bounds
+	ParallelFor(Targets.Num(), [&](int32 Index)
+	{
+		FSExplosionTarget& Target = Targets[Index];
+		FVector TraceEnd = Target.Component->Bounds.Origin;
+
+		if (World->LineTraceSingleByChannel(Target.Hit, Explosion.Origin, TraceEnd, ECC_Visibility, QueryParams))
+		{
+			Target.bVisible = Target.Hit.Component == Target.Component;
+		}
+		else
+		{
+			FVector FakeHitNormal = (Explosion.Origin - TraceEnd).GetSafeNormal();
+			Target.Hit = FHitResult(Target.Component->GetOwner(), Target.Component, TraceEnd, FakeHitNormal);
+			Target.bVisible = true;
+		}
+	}, Targets.Num() < ParallelExplosionTraceThreshold);
+}
+
+void USExplosionResolverComponent::Resolve(const FSExplosion& Explosion)
+{
+	COOP_HOT_PATH_SCOPE(Explosions);
+	INC_DWORD_STAT(STAT_ExplosionsResolved);
+
+	AActor* Source = Explosion.Source.Get();
+
+	FSCombatEventRecorder::Get().Record(ESCombatEventType::Explosion, GetWorld()->GetTimeSeconds(), FSCombatEventRecorder::GetActorId(Explosion.InstigatedBy.Get()), -1, Explosion.Origin, Explosion.Damage, (uint16)FMath::RoundToInt(Explosion.Radius / 100));
+
+	//Effects play when the damage lands, not when a chained explosion got scheduled
+	if (Source)
+	{
+		QueueExplosionCue(Source, Explosion.Origin);
+	}
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(SExplosion), false, Source);
+
+	Overlaps.Reset();
+	FSHotPathStats::AddCount(ESHotPathCounter::Traces);
+	GetWorld()->OverlapMultiByObjectType(Overlaps, Explosion.Origin, FQuat::Identity, FCollisionObjectQueryParams(FCollisionObjectQueryParams::InitType::AllDynamicObjects), FCollisionShape::MakeSphere(Explosion.Radius), QueryParams);
+
+	Targets.Reset();
+
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		UPrimitiveComponent* Component = Overlap.Component.Get();
+
+		if (Component && Component->GetOwner() != Source)
+		{
+			Targets.Add({ Component, FHitResult(), false });
+		}
+	}
+
+	if (Explosion.Damage > 0 && Targets.Num() > 0)
+	{
+		TraceVisibility(Explosion, QueryParams);
+
+		//One damage event per actor carrying every visible component, like ApplyRadialDamage
+		TArray<AActor*, TInlineAllocator<16>> Victims;
+		TArray<FRadialDamageEvent, TInlineAllocator<16>> Events;
+
+		for (const FSExplosionTarget& Target : Targets)
+		{
+			AActor* Victim = Target.Component->GetOwner();
+
+			if (!Target.bVisible || !Victim)
+			{
+				continue;
+			}
+
+			int32 VictimIndex = Victims.Find(Victim);
+
+			if (VictimIndex == INDEX_NONE)
+			{
+				VictimIndex = Victims.Add(Victim);
+
+				FRadialDamageEvent& Event = Events.AddDefaulted_GetRef();
+				Event.Params = FRadialDamageParams(Explosion.Damage, Explosion.Radius);
+				Event.Origin = Explosion.Origin;
+				Event.DamageTypeClass = Explosion.DamageType ? Explosion.DamageType : TSubclassOf<UDamageType>(UDamageType::StaticClass());
+			}
+
+			Events[VictimIndex].ComponentHits.Add(Target.Hit);
+		}
+
+		for (int32 i = 0; i < Victims.Num(); i++)
+		{
+			if (!Victims[i]->IsPendingKillPending())
+			{
+				Victims[i]->TakeDamage(Explosion.Damage, Events[i], Explosion.InstigatedBy.Get(), Explosion.DamageCauser.Get());
+			}
+		}
+	}
+
+	//Same overlaps push every component, occluded or not, like RadialForceComponent::FireImpulse
+	if (Explosion.ImpulseStrength > 0)
+	{
+		for (const FSExplosionTarget& Target : Targets)
+		{
+			if (!IsValid(Target.Component))
+			{
+				continue;
+			}
+
+			Target.Component->AddRadialImpulse(Explosion.Origin, Explosion.Radius, Explosion.ImpulseStrength, Explosion.ImpulseFalloff, Explosion.bImpulseVelChange);
+
+			AActor* Owner = Target.Component->GetOwner();
+
+			if (Owner)
+			{
+				TInlineComponentArray<UMovementComponent*> MovementComponents;
+				Owner->GetComponents(MovementComponents);
+
+				for (UMovementComponent* MovementComponent : MovementComponents)
+				{
+					if (MovementComponent->UpdatedComponent == Target.Component)
+					{
+						MovementComponent->AddRadialImpulse(Explosion.Origin, Explosion.Radius, Explosion.ImpulseStrength, Explosion.ImpulseFalloff, Explosion.bImpulseVelChange);
+						break;
+					}
+				}
+			}
+		}
+	}
+}
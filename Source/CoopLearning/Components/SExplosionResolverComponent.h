@@ -0,0 +1,127 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "PhysicsEngine/RadialForceComponent.h"
+#include "Engine/NetSerialization.h"
+#include "SExplosionResolverComponent.generated.h"
+
+class UDamageType;
+class UPrimitiveComponent;
+class AController;
+
+USTRUCT()
+struct FSExplosionCue
+{
+	GENERATED_BODY()
+
+	//Must implement ISExplosive to play anything
+	UPROPERTY()
+	AActor* Source = nullptr;
+
+	UPROPERTY()
+	FVector_NetQuantize Location;
+};
+
+//Everything needed to resolve one explosion after the exploding actor moved on
+struct FSExplosion
+{
+	FVector Origin = FVector::ZeroVector;
+
+	float Radius = 0;
+
+	//Applied in full inside Radius, like ApplyRadialDamage with bDoFullDamage
+	float Damage = 0;
+
+	TSubclassOf<UDamageType> DamageType;
+
+	float ImpulseStrength = 0;
+
+	TEnumAsByte<ERadialImpulseFalloff> ImpulseFalloff = RIF_Constant;
+
+	bool bImpulseVelChange = false;
+
+	//The exploding actor, it neither takes damage nor impulse from itself
+	TWeakObjectPtr<AActor> Source;
+
+	TWeakObjectPtr<AActor> DamageCauser;
+
+	TWeakObjectPtr<AController> InstigatedBy;
+
+	//Set by the resolver, world time the explosion resolves at
+	float DueTime = 0;
+
+	//Fills radius and impulse settings from the exploding actors force component
+	void SetImpulseFrom(const URadialForceComponent* RadialForceComp);
+};
+
+UCLASS( ClassGroup=(COOP), meta=(BlueprintSpawnableComponent) )
+class COOPLEARNING_API USExplosionResolverComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:	
+	// Sets default values for this component's properties
+	USExplosionResolverComponent();
+
+protected:
+
+	//Delay before an explosion set off by another explosion resolves, spreads barrel chains over frames
+	UPROPERTY(EditDefaultsOnly, Category = "Explosions")
+	float SecondaryExplosionDelay;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Explosions")
+	int32 MaxExplosionsPerTick;
+
+	//Ordered by due time
+	TArray<FSExplosion> PendingExplosions;
+
+	bool bResolving;
+
+	uint64 BudgetFrame;
+
+	int32 ResolvedThisFrame;
+
+	//Resolves due explosions until the frame budget is spent
+	void ProcessPending();
+
+	//One overlap query feeds both damage and impulse
+	void Resolve(const FSExplosion& Explosion);
+
+	struct FSExplosionTarget
+	{
+		UPrimitiveComponent* Component;
+
+		FHitResult Hit;
+
+		bool bVisible;
+	};
+
+	//Reused between explosions
+	TArray<FOverlapResult> Overlaps;
+
+	TArray<FSExplosionTarget> Targets;
+
+	//Visibility from the origin for every target, traced in parallel once there are enough of them
+	void TraceVisibility(const FSExplosion& Explosion, const FCollisionQueryParams& QueryParams);
+
+	//Collected during the frame, sent in one multicast
+	TArray<FSExplosionCue> PendingCues;
+
+	UFUNCTION(NetMulticast, Reliable)
+	void MulticastExplosionCues(const TArray<FSExplosionCue>& Cues);
+
+	void UpdateTickEnabled();
+
+public:
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	//Server only. Resolves right away while the frame budget lasts, explosions set off by another one are delayed by SecondaryExplosionDelay
+	void Explode(const FSExplosion& Explosion);
+
+	//Server only. The effects of Source play on all machines with the next batch, resolved explosions queue their own
+	void QueueExplosionCue(AActor* Source, const FVector& Location);
+};
@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "SFireSchedulerComponent.h"
+#include "SWeapon.h"
+#include "CoopLearning.h"
+#include "SHotPathStats.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Scheduled Shots"), STAT_ScheduledShots, STATGROUP_CoopLearning);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Firing Weapons"), STAT_FiringWeapons, STATGROUP_CoopLearning);
+
+USFireSchedulerComponent::USFireSchedulerComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickGroup = TG_PrePhysics;
+
+	MaxShotsPerWeaponPerTick = 8;
+}
+
+void USFireSchedulerComponent::StartFiring(ASWeapon* Weapon, float FirstDelay, float TimeBetweenShots)
+{
+	if (!Weapon || TimeBetweenShots <= 0)
+	{
+		return;
+	}
+
+	FSFiringWeapon* Existing = FiringWeapons.FindByPredicate([Weapon](const FSFiringWeapon& Firing) { return Firing.Weapon == Weapon; });
+
+	if (Existing)
+	{
+		return;
+	}
+
+	FSFiringWeapon Firing;
+	Firing.Weapon = Weapon;
+	Firing.TimeToNextShot = FirstDelay;
+	Firing.TimeBetweenShots = TimeBetweenShots;
+
+	FiringWeapons.Add(Firing);
+}
+
+void USFireSchedulerComponent::StopFiring(ASWeapon* Weapon)
+{
+	int32 Index = FiringWeapons.IndexOfByPredicate([Weapon](const FSFiringWeapon& Firing) { return Firing.Weapon == Weapon; });
+
+	if (Index != INDEX_NONE)
+	{
+		FiringWeapons.RemoveAtSwap(Index, 1, false);
+	}
+}
+
+void USFireSchedulerComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (FiringWeapons.Num() == 0)
+	{
+		return;
+	}
+
+	COOP_HOT_PATH_SCOPE(FireScheduler);
+
+	SET_DWORD_STAT(STAT_FiringWeapons, FiringWeapons.Num());
+
+	DueShots.Reset();
+
+	//Advance every accumulator first, a long frame yields every shot it covered instead of one
+	for (int32 i = FiringWeapons.Num() - 1; i >= 0; i--)
+	{
+		FSFiringWeapon& Firing = FiringWeapons[i];
+
+		if (!IsValid(Firing.Weapon))
+		{
+			FiringWeapons.RemoveAtSwap(i, 1, false);
+			continue;
+		}
+
+		Firing.TimeToNextShot -= DeltaTime;
+
+		int32 Shots = 0;
+
+		while (Firing.TimeToNextShot <= 0 && Shots < MaxShotsPerWeaponPerTick)
+		{
+			DueShots.Add(Firing.Weapon);
+			Firing.TimeToNextShot += Firing.TimeBetweenShots;
+			Shots++;
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_ScheduledShots, DueShots.Num());
+
+	//Firing may stop a weapon (empty magazine, owner died), which only touches FiringWeapons
+	for (ASWeapon* Weapon : DueShots)
+	{
+		if (IsValid(Weapon))
+		{
+			Weapon->FireScheduledShot();
+		}
+	}
+}
@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "SFireSchedulerComponent.generated.h"
+
+class ASWeapon;
+
+USTRUCT()
+struct FSFiringWeapon
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	ASWeapon* Weapon = nullptr;
+
+	//Seconds until the next shot, at or below zero means a shot is due
+	float TimeToNextShot = 0;
+
+	float TimeBetweenShots = 0;
+};
+
+UCLASS( ClassGroup=(COOP), meta=(BlueprintSpawnableComponent) )
+class COOPLEARNING_API USFireSchedulerComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:	
+	// Sets default values for this component's properties
+	USFireSchedulerComponent();
+
+protected:
+
+	//Weapons with the trigger held on this machine, densely packed
+	UPROPERTY()
+	TArray<FSFiringWeapon> FiringWeapons;
+
+	//Shots due this tick, filled and emitted in one pass
+	UPROPERTY()
+	TArray<ASWeapon*> DueShots;
+
+	//Shots one weapon may emit per tick. Shots over it are not dropped, they carry over to the next ticks
+	UPROPERTY(EditDefaultsOnly, Category = "FireScheduler", meta = (ClampMin = 1))
+	int32 MaxShotsPerWeaponPerTick;
+
+public:
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	void StartFiring(ASWeapon* Weapon, float FirstDelay, float TimeBetweenShots);
+
+	void StopFiring(ASWeapon* Weapon);
+};
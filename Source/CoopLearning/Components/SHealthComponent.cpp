@@ -3,6 +3,7 @@
 #include "Net/UnrealNetwork.h"
 #include "SCharacter.h"
 #include "GameFramework/Controller.h"
+#include "SCombatEventRecorder.h"
 
 // Sets default values for this component's properties
 USHealthComponent::USHealthComponent()
@@ -36,7 +37,8 @@ void USHealthComponent::HandleTakeAnyDamage(AActor * DamagedActor, float Damage,
 
 	Health = FMath::Clamp(Health - Damage, 0.0f, MaxHealth);
 
-	UE_LOG(LogTemp, Log, TEXT("Health Changed: %s"), *FString::SanitizeFloat(Health));
+	AActor* MyOwner = GetOwner();
+	FSCombatEventRecorder::Get().Record(ESCombatEventType::Damage, GetWorld()->GetTimeSeconds(), FSCombatEventRecorder::GetActorId(InstigatedBy), FSCombatEventRecorder::GetActorId(MyOwner), MyOwner->GetActorLocation(), Damage, (uint16)FMath::CeilToInt(Health));
 
 	OnHealthChanged.Broadcast(this, Health, Damage, DamageType, InstigatedBy, DamageCauser);
 
@@ -62,6 +64,11 @@ void USHealthComponent::ForceHealthTo(float amount)
 	HandleTakeAnyDamage(nullptr, Health, nullptr, nullptr, nullptr);
 }
 
+void USHealthComponent::ResetHealth()
+{
+	Health = MaxHealth;
+}
+
 void USHealthComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
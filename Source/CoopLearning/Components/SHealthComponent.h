@@ -41,4 +41,7 @@ public:
 
 	void ForceHealthTo(float amount);
 
+	//Back to MaxHealth without broadcasting, for actors that get reused
+	void ResetHealth();
+
 };
@@ -0,0 +1,330 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "SLagCompensationComponent.h"
+#include "GameFramework/Character.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "SGameMode.h"
+#include "HAL/IConsoleManager.h"
+#include "SHotPathStats.h"
+#include "TimerManager.h"
+#include "CoopLearning.h"
+
+static float MaxLagCompensationTime = 0.4f;
+
+FAutoConsoleVariableRef CVARMaxLagCompensationTime (TEXT("MaxLagCompensationTime"), MaxLagCompensationTime, TEXT("Oldest time in seconds a shot may be rewound to"), ECVF_Cheat);
+
+//Hitboxes are checked against slightly inflated bounds, the mesh bounds do not cover the whole physics asset in every pose
+static const float BroadPhaseMargin = 50.0f;
+
+void FSPoseHistory::Init(int32 Capacity)
+{
+	Snapshots.SetNumUninitialized(FMath::Max(Capacity, 2));
+	HistoryBounds = FBox(ForceInit);
+	Head = 0;
+	Count = 0;
+}
+
+void FSPoseHistory::Record(float Time, const FVector& Location, const FQuat& Rotation, const FBox& Bounds)
+{
+	FSPoseSnapshot& Snapshot = Snapshots[Head];
+	Snapshot.Time = Time;
+	Snapshot.Location = Location;
+	Snapshot.Rotation = Rotation;
+	Snapshot.Bounds = Bounds.ExpandBy(BroadPhaseMargin);
+
+	Head = (Head + 1) % Snapshots.Num();
+	Count = FMath::Min(Count + 1, Snapshots.Num());
+
+	HistoryBounds = FBox(ForceInit);
+
+	for (int32 i = 0; i < Count; i++)
+	{
+		HistoryBounds += Snapshots[i].Bounds;
+	}
+}
+
+const FSPoseSnapshot& FSPoseHistory::GetFromNewest(int32 Age) const
+{
+	int32 Index = Head - 1 - Age;
+
+	if (Index < 0)
+	{
+		Index += Snapshots.Num();
+	}
+
+	return Snapshots[Index];
+}
+
+bool FSPoseHistory::Sample(float Time, FVector& OutLocation, FQuat& OutRotation) const
+{
+	if (Count == 0 || Time > GetFromNewest(0).Time || Time < GetFromNewest(Count - 1).Time)
+	{
+		return false;
+	}
+
+	//Walk back from the newest snapshot, shots are usually only a few ticks old
+	for (int32 Age = 0; Age < Count - 1; Age++)
+	{
+		const FSPoseSnapshot& Newer = GetFromNewest(Age);
+		const FSPoseSnapshot& Older = GetFromNewest(Age + 1);
+
+		if (Time >= Older.Time)
+		{
+			float Alpha = Newer.Time > Older.Time ? (Time - Older.Time) / (Newer.Time - Older.Time) : 1.0f;
+
+			OutLocation = FMath::Lerp(Older.Location, Newer.Location, Alpha);
+			OutRotation = FQuat::Slerp(Older.Rotation, Newer.Rotation, Alpha);
+			return true;
+		}
+	}
+
+	OutLocation = GetFromNewest(0).Location;
+	OutRotation = GetFromNewest(0).Rotation;
+	return true;
+}
+
+bool FSPoseHistory::MayIntersectRay(const FVector& Start, const FVector& End) const
+{
+	if (Count == 0)
+	{
+		return false;
+	}
+
+	return FMath::LineBoxIntersection(HistoryBounds, Start, End, End - Start);
+}
+
+// Sets default values for this component's properties
+USLagCompensationComponent::USLagCompensationComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
+
+	HistorySize = 32;
+}
+
+// Called when the game starts
+void USLagCompensationComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	AActor* MyOwner = GetOwner();
+
+	if (MyOwner && MyOwner->Role == ROLE_Authority)
+	{
+		ACharacter* Character = Cast<ACharacter>(MyOwner);
+		HitboxComp = Character ? Character->GetMesh() : MyOwner->GetRootComponent();
+
+		History.Init(HistorySize);
+
+		ASGameMode* GM = GetWorld()->GetAuthGameMode<ASGameMode>();
+
+		if (GM)
+		{
+			GM->RegisterLagCompensation(this);
+		}
+
+		SetComponentTickEnabled(true);
+	}
+}
+
+void USLagCompensationComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	ASGameMode* GM = GetWorld()->GetAuthGameMode<ASGameMode>();
+
+	if (GM)
+	{
+		GM->UnregisterLagCompensation(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void USLagCompensationComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (HitboxComp)
+	{
+		History.Record(GetWorld()->GetTimeSeconds(), HitboxComp->GetComponentLocation(), HitboxComp->GetComponentQuat(), HitboxComp->Bounds.GetBox());
+	}
+}
+
+bool USLagCompensationComponent::CanRewind() const
+{
+	return HitboxComp && !HitboxComp->IsSimulatingPhysics();
+}
+
+bool USLagCompensationComponent::Rewind(float Time)
+{
+	FVector Location;
+	FQuat Rotation;
+
+	if (!HitboxComp || bRewound || !History.Sample(Time, Location, Rotation))
+	{
+		return false;
+	}
+
+	SavedRelativeTransform = HitboxComp->GetRelativeTransform();
+	HitboxComp->SetWorldLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+	bRewound = true;
+
+	return true;
+}
+
+void USLagCompensationComponent::Restore()
+{
+	if (HitboxComp && bRewound)
+	{
+		HitboxComp->SetRelativeTransform(SavedRelativeTransform, false, nullptr, ETeleportType::TeleportPhysics);
+	}
+
+	bRewound = false;
+}
+
+FSScopedLagCompensation::FSScopedLagCompensation(UWorld* World, float RewindTime, const FVector& RayStart, TArrayView<const FVector> RayEnds, AActor* IgnoredActor)
+{
+	COOP_HOT_PATH_SCOPE(LagCompensation);
+
+	ASGameMode* GM = World ? World->GetAuthGameMode<ASGameMode>() : nullptr;
+
+	if (!GM)
+	{
+		return;
+	}
+
+	float Now = World->GetTimeSeconds();
+	RewindTime = FMath::Clamp(RewindTime, Now - MaxLagCompensationTime, Now);
+
+	//Nothing to do for shots from the present, like the listen server host
+	if (RewindTime >= Now)
+	{
+		return;
+	}
+
+	for (USLagCompensationComponent* Comp : GM->GetLagCompensatedComponents())
+	{
+		if (!Comp || Comp->GetOwner() == IgnoredActor || !Comp->CanRewind())
+		{
+			continue;
+		}
+
+		const FSPoseHistory& History = Comp->GetHistory();
+
+		for (const FVector& RayEnd : RayEnds)
+		{
+			if (History.MayIntersectRay(RayStart, RayEnd))
+			{
+				if (Comp->Rewind(RewindTime))
+				{
+					Rewound.Add(Comp);
+				}
+				break;
+			}
+		}
+	}
+}
+
+FSScopedLagCompensation::~FSScopedLagCompensation()
+{
+	for (USLagCompensationComponent* Comp : Rewound)
+	{
+		Comp->Restore();
+	}
+}
+
+//Full rewind, trace and restore cost per shot against spawned characters, and the same trace without rewinding
+static void RunLagCompensationBenchmark(UWorld* World, TArray<TWeakObjectPtr<APawn>> Pawns, int32 ShotCount)
+{
+	TArray<FVector> Targets;
+
+	for (const TWeakObjectPtr<APawn>& Pawn : Pawns)
+	{
+		if (Pawn.IsValid())
+		{
+			Targets.Add(Pawn->GetActorLocation());
+		}
+	}
+
+	if (Targets.Num() == 0)
+	{
+		return;
+	}
+
+	FRandomStream Random(1234);
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(LagCompensationBenchmark), true);
+	float Now = World->GetTimeSeconds();
+
+	double RewoundSeconds = 0;
+	double PresentSeconds = 0;
+	int32 RewoundHits = 0;
+	int32 PresentHits = 0;
+
+	for (int32 Shot = 0; Shot < ShotCount; Shot++)
+	{
+		FVector Target = Targets[Random.RandHelper(Targets.Num())] + Random.GetUnitVector() * 60;
+		FVector RayStart = Target + Random.GetUnitVector() * FVector(3000, 3000, 200);
+		FVector RayEnd = RayStart + (Target - RayStart) * 2;
+		FVector RayEnds[] = { RayEnd };
+		FHitResult Hit;
+
+		double StartTime = FPlatformTime::Seconds();
+
+		{
+			FSScopedLagCompensation LagCompensation(World, Now - Random.FRandRange(0.05f, 0.2f), RayStart, RayEnds, nullptr);
+			RewoundHits += World->LineTraceSingleByChannel(Hit, RayStart, RayEnd, COLLISION_WEAPON, QueryParams) ? 1 : 0;
+		}
+
+		RewoundSeconds += FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		PresentHits += World->LineTraceSingleByChannel(Hit, RayStart, RayEnd, COLLISION_WEAPON, QueryParams) ? 1 : 0;
+		PresentSeconds += FPlatformTime::Seconds() - StartTime;
+	}
+
+	double RewoundUs = RewoundSeconds * 1000000.0 / ShotCount;
+	double PresentUs = PresentSeconds * 1000000.0 / ShotCount;
+
+	UE_LOG(LogTemp, Log, TEXT("Lag compensation: %d characters, %d shots, rewind + trace + restore %.3f us per shot, trace alone %.3f us, rewind cost %.3f us (%d/%d hits)"), Targets.Num(), ShotCount, RewoundUs, PresentUs, RewoundUs - PresentUs, RewoundHits, PresentHits);
+
+	for (const TWeakObjectPtr<APawn>& Pawn : Pawns)
+	{
+		if (Pawn.IsValid())
+		{
+			Pawn->Destroy();
+		}
+	}
+}
+
+//Spawns the characters, then measures once their pose histories covered the rewind window
+static void BenchmarkLagCompensation(const TArray<FString>& Args, UWorld* World)
+{
+	int32 CharacterCount = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 64;
+	int32 ShotCount = FMath::Max(Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 1000, 1);
+
+	ASGameMode* GM = World ? World->GetAuthGameMode<ASGameMode>() : nullptr;
+	UClass* PawnClass = GM ? GM->GetDefaultPawnClassForController(nullptr) : nullptr;
+
+	if (!PawnClass)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("BenchmarkLagCompensation: needs to run on the server of a started match"));
+		return;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	TArray<TWeakObjectPtr<APawn>> Pawns;
+	int32 Columns = FMath::CeilToInt(FMath::Sqrt((float)CharacterCount));
+
+	for (int32 i = 0; i < CharacterCount; i++)
+	{
+		FVector Location = FVector((i % Columns) * 250.0f, (i / Columns) * 250.0f, 200.0f);
+		Pawns.Add(World->SpawnActor<APawn>(PawnClass, Location, FRotator::ZeroRotator, SpawnParams));
+	}
+
+	FTimerHandle TimerHandle;
+	World->GetTimerManager().SetTimer(TimerHandle, FTimerDelegate::CreateStatic(&RunLagCompensationBenchmark, World, Pawns, ShotCount), 1.0f, false);
+}
+
+FAutoConsoleCommandWithWorldAndArgs BenchmarkLagCompensationCommand(TEXT("BenchmarkLagCompensation"), TEXT("BenchmarkLagCompensation [Characters=64] [Shots=1000], server only, spawns the characters and logs the result a second later"), FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&BenchmarkLagCompensation));
@@ -0,0 +1,107 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Containers/ArrayView.h"
+#include "SLagCompensationComponent.generated.h"
+
+class USceneComponent;
+
+//One server tick worth of hitbox placement
+struct FSPoseSnapshot
+{
+	float Time;
+
+	FVector Location;
+
+	FQuat Rotation;
+
+	FBox Bounds;
+};
+
+//Fixed size ring of snapshots, allocated once and overwritten in place
+struct COOPLEARNING_API FSPoseHistory
+{
+	void Init(int32 Capacity);
+
+	void Record(float Time, const FVector& Location, const FQuat& Rotation, const FBox& Bounds);
+
+	//Interpolated placement at Time, false if Time is not covered by the history
+	bool Sample(float Time, FVector& OutLocation, FQuat& OutRotation) const;
+
+	//Broad phase, does the ray touch anywhere this hitbox has been during the history
+	bool MayIntersectRay(const FVector& Start, const FVector& End) const;
+
+	int32 Num() const { return Count; }
+
+protected:
+
+	TArray<FSPoseSnapshot> Snapshots;
+
+	//Union of every recorded Bounds, rebuilt on Record
+	FBox HistoryBounds;
+
+	int32 Head = 0;
+
+	int32 Count = 0;
+
+	const FSPoseSnapshot& GetFromNewest(int32 Age) const;
+};
+
+UCLASS( ClassGroup=(COOP), meta=(BlueprintSpawnableComponent) )
+class COOPLEARNING_API USLagCompensationComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:	
+	// Sets default values for this component's properties
+	USLagCompensationComponent();
+
+protected:
+	// Called when the game starts
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	//Snapshots kept, at a 30Hz server tick 32 covers about a second
+	UPROPERTY(EditDefaultsOnly, Category = "LagCompensation", meta = (ClampMin = 2, ClampMax = 256))
+	int32 HistorySize;
+
+	//Component that carries the hitboxes, the owners mesh for characters
+	UPROPERTY()
+	USceneComponent* HitboxComp;
+
+	FSPoseHistory History;
+
+	FTransform SavedRelativeTransform;
+
+	bool bRewound;
+
+public:
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	const FSPoseHistory& GetHistory() const { return History; }
+
+	//Ragdolls, like dead characters, are driven by physics and must not be teleported
+	bool CanRewind() const;
+
+	//Moves the hitboxes to where they were at Time, false if there is no history for it
+	bool Rewind(float Time);
+
+	void Restore();
+};
+
+//Rewinds every lag compensated hitbox a set of shot rays can touch for the lifetime of the scope
+struct COOPLEARNING_API FSScopedLagCompensation
+{
+	FSScopedLagCompensation(UWorld* World, float RewindTime, const FVector& RayStart, TArrayView<const FVector> RayEnds, AActor* IgnoredActor);
+
+	~FSScopedLagCompensation();
+
+protected:
+
+	TArray<USLagCompensationComponent*, TInlineAllocator<8>> Rewound;
+};
@@ -3,6 +3,9 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("CoopLearning"), STATGROUP_CoopLearning, STATCAT_Advanced);
 
 #define SURFACE_FLESHDEFAULT SurfaceType1
 #define SURFACE_FLESHVULNERABLE SurfaceType2
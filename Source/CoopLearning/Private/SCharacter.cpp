@@ -8,6 +8,7 @@
 #include "Engine/World.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/SHealthComponent.h"
+#include "Components/SLagCompensationComponent.h"
 #include "Components/SphereComponent.h"
 #include "Net/UnrealNetwork.h"
 #include "CoopLearning.h"
@@ -15,6 +16,8 @@
 #include "GameFramework/Controller.h"
 #include "GameFramework/GameModeBase.h"
 #include "SPlayerController.h"
+#include "SGameMode.h"
+#include "Components/SActorPoolComponent.h"
 #include "TimerManager.h"
 #include "GameFramework/PlayerState.h"
 #include "SZipline.h"
@@ -26,6 +29,73 @@
 #include "SPlayerController.h"
 #include "Components/StaticMeshComponent.h"
 #include "Sound/SoundCue.h"
+#include "Components/SAudioDispatchComponent.h"
+#include "Engine/NetSerialization.h"
+#include "SHotPathStats.h"
+
+static int32 CharacterNetStats = 0;
+
+FAutoConsoleVariableRef CVARCharacterNetStats (TEXT("CharacterNetStats"), CharacterNetStats, TEXT("Measure the replicated character state payload against the old per property layout, shown in stat CoopLearning"), ECVF_Default);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Character State Bytes Total (old)"), STAT_CharacterStateBytesOld, STATGROUP_CoopLearning);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Character State Bytes Total (packed)"), STAT_CharacterStateBytesPacked, STATGROUP_CoopLearning);
+
+//Width of State on the wire
+static const int64 CharacterStateBits = 2;
+
+static_assert(STATE_MAX <= (1 << CharacterStateBits), "ECharacterState no longer fits in CharacterStateBits");
+
+bool FSCharacterRepState::operator==(const FSCharacterRepState& Other) const
+{
+	return AimProgress == Other.AimProgress
+		&& State == Other.State
+		&& bDied == Other.bDied
+		&& ZiplineDirectionIsForward == Other.ZiplineDirectionIsForward
+		&& GranadeCount == Other.GranadeCount
+		&& CurrentZipline == Other.CurrentZipline;
+}
+
+void FSCharacterRepState::SerializeBits(FArchive& Ar)
+{
+	Ar << AimProgress;
+
+	uint8 StateBits = State;
+	Ar.SerializeBits(&StateBits, CharacterStateBits);
+	State = (ECharacterState)StateBits;
+
+	uint8 Flags = (bDied ? 1 : 0) | (ZiplineDirectionIsForward ? 2 : 0);
+	Ar.SerializeBits(&Flags, 2);
+	bDied = (Flags & 1) != 0;
+	ZiplineDirectionIsForward = (Flags & 2) != 0;
+
+	uint32 PackedGranadeCount = GranadeCount;
+	Ar.SerializeIntPacked(PackedGranadeCount);
+	GranadeCount = PackedGranadeCount;
+}
+
+bool FSCharacterRepState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+
+	SerializeBits(Ar);
+
+	//Only characters riding a zipline pay for the reference
+	uint8 HasZipline = CurrentZipline ? 1 : 0;
+	Ar.SerializeBits(&HasZipline, 1);
+
+	if (HasZipline)
+	{
+		UObject* Zipline = CurrentZipline;
+		bOutSuccess &= Map->SerializeObject(Ar, ASZipline::StaticClass(), Zipline);
+		CurrentZipline = Cast<ASZipline>(Zipline);
+	}
+	else
+	{
+		CurrentZipline = nullptr;
+	}
+
+	return true;
+}
 
 // Sets default values
 ASCharacter::ASCharacter()
@@ -41,6 +111,8 @@ ASCharacter::ASCharacter()
 
 	HealthComp = CreateDefaultSubobject<USHealthComponent>(TEXT("HealthComp"));
 
+	LagCompensationComp = CreateDefaultSubobject<USLagCompensationComponent>(TEXT("LagCompensationComp"));
+
 	DetectionComp = CreateDefaultSubobject<USphereComponent>(TEXT("DetectionComp"));
 	DetectionComp->SetupAttachment(RootComponent);
 
@@ -58,6 +130,7 @@ ASCharacter::ASCharacter()
 	DefaultMeleeDamage = 50;
 
 	State = STATE_Normal;
+	LastSentAimProgress = 0;
 }
 
 void ASCharacter::BeginPlay()
@@ -180,6 +253,7 @@ void ASCharacter::BeginZoom()
 	if (Role < ROLE_Authority)
 	{
 		ServerBeginZoom();
+		FSHotPathStats::AddCount(ESHotPathCounter::CharacterRPCs);
 	}
 }
 
@@ -190,6 +264,7 @@ void ASCharacter::EndZoom()
 	if (Role < ROLE_Authority)
 	{
 		ServerEndZoom();
+		FSHotPathStats::AddCount(ESHotPathCounter::CharacterRPCs);
 	}
 }
 
@@ -237,6 +312,7 @@ USHealthComponent* ASCharacter::GetHealthComponent()
 void ASCharacter::NotifyDamageDealt(float Amount)
 {
 	MulticastNotifyDamageDealt(Amount);
+	FSHotPathStats::AddCount(ESHotPathCounter::CharacterRPCs);
 }
 
 void ASCharacter::SpawnWeapon()
@@ -253,10 +329,22 @@ void ASCharacter::SpawnWeapon()
 
 	UE_LOG(LogTemp, Log, TEXT("Respawning with Weapon: %s"), *WeaponClass->GetName());
 
-	FActorSpawnParameters SpawnParams;
-	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	ASWeapon* NewWeapon = nullptr;
+	ASGameMode* GM = GetWorld()->GetAuthGameMode<ASGameMode>();
+
+	if (GM)
+	{
+		NewWeapon = GM->GetActorPool()->Acquire<ASWeapon>(WeaponClass, FTransform::Identity, this);
+	}
+	else
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		NewWeapon = GetWorld()->SpawnActor<ASWeapon>(WeaponClass, FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
+		FSHotPathStats::AddCount(ESHotPathCounter::ActorsSpawned);
+	}
 
-	ASWeapon* NewWeapon = GetWorld()->SpawnActor<ASWeapon>(WeaponClass, FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
 	EquipWeapon(NewWeapon);
 }
 
@@ -291,21 +379,19 @@ void ASCharacter::TryPickup()
 	{
 		if (Role >= ROLE_Authority) 
 		{
-			EquipWeapon(ClosestWeapon);
+			EquipWeapon(FindClosestPickupWeapon());
 		}
 		else 
 		{
 			ServerTryPickup();
+			FSHotPathStats::AddCount(ESHotPathCounter::CharacterRPCs);
 		}
 	}
 }
 
 void ASCharacter::ServerTryPickup_Implementation()
 {
-	if (ClosestWeapon)
-	{
-		EquipWeapon(ClosestWeapon);
-	}
+	EquipWeapon(FindClosestPickupWeapon());
 }
 
 bool ASCharacter::ServerTryPickup_Validate()
@@ -318,6 +404,7 @@ void ASCharacter::BeginDrop()
 	if (CurrentWeapon)
 	{
 		ServerTryDrop();
+		FSHotPathStats::AddCount(ESHotPathCounter::CharacterRPCs);
 		StopFire();
 	}
 }
@@ -327,6 +414,7 @@ void ASCharacter::BeginInteract()
 	if (Role < ROLE_Authority) 
 	{
 		ServerTryInteract();
+		FSHotPathStats::AddCount(ESHotPathCounter::CharacterRPCs);
 		return;
 	}
 
@@ -347,6 +435,7 @@ void ASCharacter::BeginMelee()
 	if (Role < ROLE_Authority) 
 	{
 		ServerBeginMelee();
+		FSHotPathStats::AddCount(ESHotPathCounter::CharacterRPCs);
 		return;
 	}
 
@@ -382,6 +471,7 @@ void ASCharacter::BeginGranade()
 	if (State == STATE_Normal && GranadeCount > 0) 
 	{
 		ServerBeginGranade();
+		FSHotPathStats::AddCount(ESHotPathCounter::CharacterRPCs);
 	}
 
 }
@@ -478,6 +568,7 @@ void ASCharacter::OnHeathChanged(USHealthComponent * SourceHealthComp, float Hea
 		BeginDrop();
 		GetMesh()->SetSimulatePhysics(true);
 		MulticastOnDeathEffects();
+		FSHotPathStats::AddCount(ESHotPathCounter::CharacterRPCs);
 		UE_LOG(LogTemp, Log, TEXT("Calling OnDeath"));
 		OnDeath.Broadcast(this, InstigatedBy, DamageCauser);
 
@@ -503,40 +594,42 @@ void ASCharacter::MulticastOnDeathEffects_Implementation()
 
 	if (DeathSound)
 	{
-		UGameplayStatics::PlaySoundAtLocation(GetWorld(), DeathSound, GetActorLocation(), 1, 1, 0, SoundAttenuation);
+		USAudioDispatchComponent::PlaySoundAtLocation(this, DeathSound, GetActorLocation(), ESSoundCategory::Character, SoundAttenuation);
 	}
 }
 
-ASWeapon* ASCharacter::GetClosestWeapon(FVector sourceLocation, TArray<AActor*> actors)
+ASWeapon* ASCharacter::FindClosestPickupWeapon() const
 {
-	if (actors.Num() <= 0)
+	ASGameMode* GM = GetWorld()->GetAuthGameMode<ASGameMode>();
+
+	if (!GM)
 	{
 		return nullptr;
 	}
 
-	ASWeapon* closestActor = nullptr;
-	float currentClosestDistance = TNumericLimits<float>::Max();
-
-	for (int i = 0; i < actors.Num(); i++)
+	AActor* Closest = GM->GetPickupGrid().FindNearest(GetActorLocation(), DetectionComp->GetScaledSphereRadius(), [this](AActor* Pickup)
 	{
-		ASWeapon* WeaponCast = Cast<ASWeapon>(actors[i]);
-		if (WeaponCast) 
-		{
-			if (WeaponCast == CurrentWeapon) 
-			{
-				continue;
-			}
+		return Pickup != CurrentWeapon && Pickup->IsA<ASWeapon>();
+	});
 
-			float distance = FVector::DistSquared(sourceLocation, actors[i]->GetActorLocation());
-			if (distance < currentClosestDistance)
-			{
-				currentClosestDistance = distance;
-				closestActor = WeaponCast;
-			}
-		}
-	}
+	return Cast<ASWeapon>(Closest);
+}
+
+void ASCharacter::UpdateClosestWeapon()
+{
+	ASGameMode* GM = GetWorld()->GetAuthGameMode<ASGameMode>();
+
+	ClosestWeaponGridVersion = GM ? GM->GetPickupGrid().GetVersion() : 0;
+	ClosestWeaponSourceLocation = GetActorLocation();
 
-	return closestActor;
+	ASWeapon* NewClosestWeapon = FindClosestPickupWeapon();
+
+	if (NewClosestWeapon != ClosestWeapon)
+	{
+		ASWeapon* OldWeapon = ClosestWeapon;
+		ClosestWeapon = NewClosestWeapon;
+		ClientNotifyClosestWeaponChange(OldWeapon, ClosestWeapon);
+	}
 }
 
 void ASCharacter::ServerTryInteract_Implementation()
@@ -566,16 +659,40 @@ void ASCharacter::ServerBeginGranade_Implementation()
 		GranadeCount -= 1;
 		SetCharacterState(STATE_Action, 1.0f);
 
-		FActorSpawnParameters SpawnParams;
-		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-
 		FVector EyeLocation;
 		FRotator EyeRotator;
 		GetActorEyesViewPoint(EyeLocation, EyeRotator);
 
 		//Spawn Granade a meter in front
-		ASGranade* Granade = GetWorld()->SpawnActor<ASGranade>(GranadeType, GetActorLocation() + GetActorForwardVector() * 100, FRotator::ZeroRotator, SpawnParams);
-		Granade->SetOwner(this);
+		FTransform SpawnTransform(FRotator::ZeroRotator, GetActorLocation() + GetActorForwardVector() * 100);
+
+		ASGranade* Granade = nullptr;
+		ASGameMode* GM = GetWorld()->GetAuthGameMode<ASGameMode>();
+
+		if (GM)
+		{
+			Granade = GM->GetActorPool()->Acquire<ASGranade>(GranadeType, SpawnTransform, this);
+		}
+		else
+		{
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+			Granade = GetWorld()->SpawnActor<ASGranade>(GranadeType, SpawnTransform, SpawnParams);
+			FSHotPathStats::AddCount(ESHotPathCounter::ActorsSpawned);
+
+			if (Granade)
+			{
+				//Same arming the pool runs on acquire
+				Granade->SetOwner(this);
+				Granade->OnAcquiredFromPool();
+			}
+		}
+
+		if (!Granade)
+		{
+			return;
+		}
 
 		FVector Impulse = (EyeRotator.Vector()).GetUnsafeNormal() *GranadeThrowForce;
 
@@ -604,6 +721,8 @@ void ASCharacter::ClientNotifyClosestWeaponChange_Implementation(ASWeapon * OldC
 // Called every frame
 void ASCharacter::Tick(float DeltaTime)
 {
+	COOP_HOT_PATH_SCOPE(CharacterTick);
+
 	Super::Tick(DeltaTime);
 
 	if (Role >= ROLE_AutonomousProxy) 
@@ -620,16 +739,12 @@ void ASCharacter::Tick(float DeltaTime)
 
 	if (Role >= ROLE_Authority) 
 	{
-		TArray<AActor*> ActorsInArea;
-		GetOverlappingActors(ActorsInArea, TSubclassOf<AActor>());
-
-		ASWeapon* NewClosestWeapon = GetClosestWeapon(GetActorLocation(), ActorsInArea);
+		ASGameMode* GM = GetWorld()->GetAuthGameMode<ASGameMode>();
 
-		if (NewClosestWeapon != ClosestWeapon)
+		//Only look again when a pickup came to rest or left, or we walked somewhere else
+		if (GM && (GM->GetPickupGrid().GetVersion() != ClosestWeaponGridVersion || !GetActorLocation().Equals(ClosestWeaponSourceLocation, 10.0f)))
 		{
-			ASWeapon* OldWeapon = ClosestWeapon;
-			ClosestWeapon = NewClosestWeapon;
-			ClientNotifyClosestWeaponChange(OldWeapon, ClosestWeapon);
+			UpdateClosestWeapon();
 		}
 	}
 
@@ -736,15 +851,101 @@ void ASCharacter::SetStateToPrevious()
 }
 
 
+void ASCharacter::PackRepState(FSCharacterRepState& OutState) const
+{
+	OutState.AimProgress = (uint8)FMath::RoundToInt(FMath::Clamp(AimProgress, 0.0f, 1.0f) * MAX_uint8);
+	OutState.State = State;
+	OutState.bDied = bDied;
+	OutState.ZiplineDirectionIsForward = ZiplineDirectionIsForward;
+	OutState.GranadeCount = (uint8)FMath::Clamp(GranadeCount, 0, (int)MAX_uint8);
+	OutState.CurrentZipline = CurrentZipline;
+}
+
+void ASCharacter::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	FSCharacterRepState NewState;
+	PackRepState(NewState);
+
+	if (CharacterNetStats > 0)
+	{
+		RecordRepStateNetStats(NewState);
+	}
+
+	//Unchanged steps leave the property as it is, the net driver finds nothing to send
+	if (!(NewState == RepState))
+	{
+		RepState = NewState;
+	}
+}
+
+void ASCharacter::OnRep_RepState()
+{
+	//The owner interpolates its own zoom every frame
+	if (!IsLocallyControlled())
+	{
+		AimProgress = (float)RepState.AimProgress / MAX_uint8;
+	}
+
+	State = RepState.State;
+	bDied = RepState.bDied;
+	ZiplineDirectionIsForward = RepState.ZiplineDirectionIsForward;
+	GranadeCount = RepState.GranadeCount;
+	CurrentZipline = RepState.CurrentZipline;
+}
+
+void ASCharacter::RecordRepStateNetStats(const FSCharacterRepState& NewState)
+{
+	//What the six separate properties cost per net update, each only when it changed. Property handles and the zipline reference are left out of both
+	FNetBitWriter OldWriter(nullptr, 256);
+
+	if (AimProgress != LastSentAimProgress)
+	{
+		float Aim = AimProgress;
+		OldWriter << Aim;
+		LastSentAimProgress = AimProgress;
+	}
+
+	if (NewState.State != RepState.State)
+	{
+		uint8 StateByte = NewState.State;
+		OldWriter << StateByte;
+	}
+
+	if (NewState.bDied != RepState.bDied)
+	{
+		OldWriter.WriteBit(NewState.bDied);
+	}
+
+	if (NewState.ZiplineDirectionIsForward != RepState.ZiplineDirectionIsForward)
+	{
+		OldWriter.WriteBit(NewState.ZiplineDirectionIsForward);
+	}
+
+	if (NewState.GranadeCount != RepState.GranadeCount)
+	{
+		int32 Count = GranadeCount;
+		OldWriter << Count;
+	}
+
+	FNetBitWriter PackedWriter(nullptr, 256);
+
+	if (!(NewState == RepState))
+	{
+		FSCharacterRepState Packed = NewState;
+		Packed.SerializeBits(PackedWriter);
+		PackedWriter.WriteBit(NewState.CurrentZipline != nullptr);
+	}
+
+	INC_DWORD_STAT_BY(STAT_CharacterStateBytesOld, OldWriter.GetNumBytes());
+	INC_DWORD_STAT_BY(STAT_CharacterStateBytesPacked, PackedWriter.GetNumBytes());
+}
+
 void ASCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const 
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
 	DOREPLIFETIME(ASCharacter, CurrentWeapon);
-	DOREPLIFETIME(ASCharacter, bDied);
-	DOREPLIFETIME(ASCharacter, AimProgress);
-	DOREPLIFETIME(ASCharacter, State);
-	DOREPLIFETIME(ASCharacter, CurrentZipline);
-	DOREPLIFETIME(ASCharacter, ZiplineDirectionIsForward);
-	DOREPLIFETIME(ASCharacter, GranadeCount);
+	DOREPLIFETIME(ASCharacter, RepState);
 }
\ No newline at end of file
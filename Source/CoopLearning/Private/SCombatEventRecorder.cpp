@@ -0,0 +1,254 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SCombatEventRecorder.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/PlatformTLS.h"
+#include "HAL/Event.h"
+#include "Misc/Paths.h"
+#include "Misc/DateTime.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/PlayerState.h"
+#include "CoopLearning.h"
+
+static int32 CombatEventLog = 1;
+
+FAutoConsoleVariableRef CVARCombatEventLog (TEXT("CombatEventLog"), CombatEventLog, TEXT("Record combat events of each match to Saved/CombatEvents, read at match start"), ECVF_Default);
+
+static int32 CombatEventFlushIntervalMs = 250;
+
+FAutoConsoleVariableRef CVARCombatEventFlushIntervalMs (TEXT("CombatEventFlushIntervalMs"), CombatEventFlushIntervalMs, TEXT("How often the combat event log is written to disk"), ECVF_Default);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Combat Events Recorded"), STAT_CombatEventsRecorded, STATGROUP_CoopLearning);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Combat Events Dropped"), STAT_CombatEventsDropped, STATGROUP_CoopLearning);
+
+FSCombatEventRecorder& FSCombatEventRecorder::Get()
+{
+	static FSCombatEventRecorder Recorder;
+	return Recorder;
+}
+
+FSCombatEventRecorder::FSCombatEventRecorder()
+	: TlsSlot(FPlatformTLS::AllocTlsSlot())
+	, File(nullptr)
+	, Thread(nullptr)
+	, WakeEvent(nullptr)
+	, bStopping(false)
+	, bRecording(false)
+{
+}
+
+FSCombatEventRecorder::~FSCombatEventRecorder()
+{
+	EndMatch();
+
+	for (FSEventRing* Ring : Rings)
+	{
+		delete Ring;
+	}
+
+	FPlatformTLS::FreeTlsSlot(TlsSlot);
+}
+
+void FSCombatEventRecorder::BeginMatch(const FString& MapName)
+{
+	EndMatch();
+
+	if (CombatEventLog <= 0)
+	{
+		return;
+	}
+
+	FString Directory = FPaths::ProjectSavedDir() / TEXT("CombatEvents");
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*Directory);
+
+	FDateTime Now = FDateTime::UtcNow();
+	FString Path = Directory / FString::Printf(TEXT("%s_%s.scev"), *FPaths::GetBaseFilename(MapName), *Now.ToString());
+
+	File = PlatformFile.OpenWrite(*Path);
+
+	if (!File)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("CombatEventRecorder: could not open %s"), *Path);
+		return;
+	}
+
+	SCombatEventFormat::FSCombatEventFileHeader Header;
+	FMemory::Memzero(Header);
+	Header.Magic = SCombatEventFormat::Magic;
+	Header.Version = SCombatEventFormat::Version;
+	Header.RecordSize = sizeof(FSCombatEventRecord);
+	Header.HeaderSize = sizeof(Header);
+	Header.StartUnixTime = Now.ToUnixTimestamp();
+	FCStringAnsi::Strncpy(Header.MapName, TCHAR_TO_ANSI(*FPaths::GetBaseFilename(MapName)), sizeof(Header.MapName));
+
+	File->Write((const uint8*)&Header, sizeof(Header));
+
+	//Leftovers of the last match belong to its file, which is closed
+	{
+		FScopeLock Lock(&RingsLock);
+
+		for (FSEventRing* Ring : Rings)
+		{
+			Ring->Tail = Ring->Head.Load();
+		}
+	}
+
+	WriteBuffer.Reserve(RingCapacity);
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	bStopping = false;
+	bRecording = true;
+
+	Thread = FRunnableThread::Create(this, TEXT("CombatEventRecorder"), 0, TPri_BelowNormal);
+
+	UE_LOG(LogTemp, Log, TEXT("CombatEventRecorder: recording to %s"), *Path);
+}
+
+void FSCombatEventRecorder::EndMatch()
+{
+	if (!bRecording)
+	{
+		return;
+	}
+
+	bRecording = false;
+
+	if (Thread)
+	{
+		Stop();
+		Thread->WaitForCompletion();
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+
+	delete File;
+	File = nullptr;
+}
+
+void FSCombatEventRecorder::Stop()
+{
+	bStopping = true;
+
+	if (WakeEvent)
+	{
+		WakeEvent->Trigger();
+	}
+}
+
+uint32 FSCombatEventRecorder::Run()
+{
+	while (!bStopping)
+	{
+		WakeEvent->Wait(FMath::Max(CombatEventFlushIntervalMs, 1));
+		Drain();
+	}
+
+	//Whatever was recorded before EndMatch
+	Drain();
+	File->Flush();
+
+	return 0;
+}
+
+FSCombatEventRecorder::FSEventRing& FSCombatEventRecorder::GetThreadRing()
+{
+	FSEventRing* Ring = (FSEventRing*)FPlatformTLS::GetTlsValue(TlsSlot);
+
+	if (!Ring)
+	{
+		Ring = new FSEventRing();
+		FPlatformTLS::SetTlsValue(TlsSlot, Ring);
+
+		FScopeLock Lock(&RingsLock);
+		Rings.Add(Ring);
+	}
+
+	return *Ring;
+}
+
+void FSCombatEventRecorder::Record(ESCombatEventType Type, float Time, int32 Instigator, int32 Target, const FVector& Location, float Value, uint16 Aux)
+{
+	if (!bRecording)
+	{
+		return;
+	}
+
+	FSEventRing& Ring = GetThreadRing();
+
+	uint32 Head = Ring.Head.Load(EMemoryOrder::Relaxed);
+
+	if (Head - Ring.Tail.Load() >= RingCapacity)
+	{
+		INC_DWORD_STAT(STAT_CombatEventsDropped);
+		return;
+	}
+
+	FSCombatEventRecord& Record = Ring.Records[Head % RingCapacity];
+	Record.Time = Time;
+	Record.Type = (uint8)Type;
+	Record.Flags = 0;
+	Record.Aux = Aux;
+	Record.Instigator = Instigator;
+	Record.Target = Target;
+	Record.X = Location.X;
+	Record.Y = Location.Y;
+	Record.Z = Location.Z;
+	Record.Value = Value;
+
+	//Publishes the record to the flush thread
+	Ring.Head = Head + 1;
+
+	INC_DWORD_STAT(STAT_CombatEventsRecorded);
+}
+
+void FSCombatEventRecorder::Drain()
+{
+	TArray<FSEventRing*, TInlineAllocator<16>> RingsToDrain;
+
+	{
+		FScopeLock Lock(&RingsLock);
+		RingsToDrain.Append(Rings);
+	}
+
+	WriteBuffer.Reset();
+
+	for (FSEventRing* Ring : RingsToDrain)
+	{
+		uint32 Tail = Ring->Tail.Load(EMemoryOrder::Relaxed);
+		uint32 Head = Ring->Head.Load();
+
+		for (; Tail != Head; Tail++)
+		{
+			WriteBuffer.Add(Ring->Records[Tail % RingCapacity]);
+		}
+
+		//Hands the slots back to the producer
+		Ring->Tail = Tail;
+	}
+
+	if (WriteBuffer.Num() > 0)
+	{
+		File->Write((const uint8*)WriteBuffer.GetData(), WriteBuffer.Num() * sizeof(FSCombatEventRecord));
+	}
+}
+
+int32 FSCombatEventRecorder::GetActorId(const AActor* Actor)
+{
+	const APlayerState* PlayerState = Cast<APlayerState>(Actor);
+
+	if (const APawn* Pawn = Cast<APawn>(Actor))
+	{
+		PlayerState = Pawn->PlayerState;
+	}
+	else if (const AController* Controller = Cast<AController>(Actor))
+	{
+		PlayerState = Controller->PlayerState;
+	}
+
+	return PlayerState ? PlayerState->PlayerId : -1;
+}
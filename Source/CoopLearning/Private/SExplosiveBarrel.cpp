@@ -9,6 +9,11 @@
 #include "PhysicsEngine/RadialForceComponent.h"
 #include "Sound/SoundAttenuation.h"
 #include "Sound/SoundCue.h"
+#include "Components/SAudioDispatchComponent.h"
+#include "Components/SExplosionResolverComponent.h"
+#include "SGameState.h"
+#include "TimerManager.h"
+#include "SHotPathStats.h"
 
 // Sets default values
 ASExplosiveBarrel::ASExplosiveBarrel()
@@ -30,8 +35,13 @@ ASExplosiveBarrel::ASExplosiveBarrel()
 	RadialForceComp->bIgnoreOwningActor = true;
 
 	ExplosionImpulse = 400;
+	DormancyDelay = 2.0f;
 
 	SetReplicates(true);
+
+	//Nothing changes until it is hit, the replication pass skips it until then
+	NetDormancy = DORM_Initial;
+	NetUpdateFrequency = 10.0f;
 }
 
 void ASExplosiveBarrel::OnHeathChanged(USHealthComponent * SourceHealthComp, float Health, float HealthDelta, const UDamageType * DamageType, AController * InstigatedBy, AActor * DamageCauser)
@@ -42,6 +52,13 @@ void ASExplosiveBarrel::OnHeathChanged(USHealthComponent * SourceHealthComp, flo
 		return;
 	}
 
+	//Health just changed, replicate it and fall back asleep once the hits stop
+	if (Role >= ROLE_Authority)
+	{
+		SetNetDormancy(DORM_Awake);
+		GetWorldTimerManager().SetTimer(TimerHandle_Dormancy, this, &ASExplosiveBarrel::GoDormant, DormancyDelay, false);
+	}
+
 	if (Health <= 0)
 	{
 		bExploded = true;
@@ -49,24 +66,39 @@ void ASExplosiveBarrel::OnHeathChanged(USHealthComponent * SourceHealthComp, flo
 
 		FVector BoostIntensity = FVector::UpVector * ExplosionImpulse;
 
-		TArray<AActor*> IgnoredActors;
-		IgnoredActors.Add(this);
-
-		UGameplayStatics::ApplyRadialDamage(GetWorld(), ExplosionDamage, GetActorLocation(), RadialForceComp->Radius, ExplosionDamageType, IgnoredActors, DamageCauser, InstigatedBy, true);
-
 		MeshComp->AddImpulse(BoostIntensity, NAME_None, true);
-		RadialForceComp->FireImpulse();
-		MulticastExplode();
+
+		ASGameState* GS = GetWorld()->GetGameState<ASGameState>();
+
+		if (GS)
+		{
+			FSExplosion Explosion;
+			Explosion.Origin = GetActorLocation();
+			Explosion.SetImpulseFrom(RadialForceComp);
+			Explosion.Damage = ExplosionDamage;
+			Explosion.DamageType = ExplosionDamageType;
+			Explosion.Source = this;
+			Explosion.DamageCauser = DamageCauser;
+			Explosion.InstigatedBy = InstigatedBy;
+
+			GS->GetExplosionResolver()->Explode(Explosion);
+		}
 	}
 }
 
-void ASExplosiveBarrel::MulticastExplode_Implementation()
+void ASExplosiveBarrel::GoDormant()
+{
+	SetNetDormancy(DORM_DormantAll);
+}
+
+void ASExplosiveBarrel::PlayExplosionEffects(const FVector& Location)
 {
 	bExploded = true;
 
 	if (ExplosionEffect)
 	{
-		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ExplosionEffect, GetActorLocation(), FRotator::ZeroRotator);
+		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ExplosionEffect, Location, FRotator::ZeroRotator);
+		FSHotPathStats::AddCount(ESHotPathCounter::EffectsSpawned);
 	}
 
 	if (MeshComp)
@@ -76,6 +108,6 @@ void ASExplosiveBarrel::MulticastExplode_Implementation()
 
 	if (ExplosionSound) 
 	{
-		UGameplayStatics::PlaySoundAtLocation(GetWorld(), ExplosionSound, GetActorLocation(), 1, 1, 0, SoundAttenuation);
+		USAudioDispatchComponent::PlaySoundAtLocation(this, ExplosionSound, Location, ESSoundCategory::Explosion, SoundAttenuation);
 	}
 }
\ No newline at end of file
@@ -3,10 +3,32 @@
 
 #include "SGameInstance.h"
 #include "SUserSaveGame.h"
+#include "SWeaponRegistry.h"
+#include "Engine/DataTable.h"
+#include "UObject/ConstructorHelpers.h"
 
 USGameInstance::USGameInstance() 
 {
 	UserSaveGameSlotName = "UserData";
+
+	static ConstructorHelpers::FObjectFinder<UDataTable> WeaponsDataTableObject(TEXT("DataTable'/Game/Core/DT_Weapons.DT_Weapons'"));
+	if (WeaponsDataTableObject.Succeeded())
+	{
+		WeaponsDataTable = WeaponsDataTableObject.Object;
+	}
+
+	static ConstructorHelpers::FObjectFinder<UDataTable> WeaponsSoundDataTableObject(TEXT("DataTable'/Game/Core/DT_WeaponsSounds.DT_WeaponsSounds'"));
+	if (WeaponsSoundDataTableObject.Succeeded())
+	{
+		WeaponsSoundDataTable = WeaponsSoundDataTableObject.Object;
+	}
+}
+
+void USGameInstance::Init()
+{
+	Super::Init();
+
+	FSWeaponRegistry::Get().Build(WeaponsDataTable, WeaponsSoundDataTable);
 }
 
 USUserSaveGame * USGameInstance::GetUserSaveGame()
@@ -5,12 +5,64 @@
 #include "SGameState.h"
 #include "SPlayerController.h"
 #include "SCharacter.h"
+#include "SWeapon.h"
 #include "GameFramework/Controller.h"
 #include "Kismet/GameplayStatics.h"
 #include "GameFramework/PlayerStart.h"
 #include "EngineUtils.h"
 #include "TimerManager.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "Components/SHealthComponent.h"
+#include "Components/SActorPoolComponent.h"
+#include "Math/VectorRegister.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetworkObjectList.h"
+#include "CoopLearning.h"
+#include "SCombatEventRecorder.h"
+#include "SHotPathStats.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Net Actors Considered"), STAT_NetActorsConsidered, STATGROUP_CoopLearning);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Net Actors Dormant"), STAT_NetActorsDormant, STATGROUP_CoopLearning);
+
+ASGameMode::ASGameMode()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	ActorPoolComp = CreateDefaultSubobject<USActorPoolComponent>(TEXT("ActorPoolComp"));
+
+	LivingCharacterSnapshotFrame = MAX_uint64;
+	MaxRespawnsPerFrame = 2;
+}
+
+void ASGameMode::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (RespawnQueue.Num() > 0)
+	{
+		ProcessRespawnQueue();
+	}
+
+	UpdateNetObjectStats();
+}
+
+void ASGameMode::UpdateNetObjectStats()
+{
+#if STATS
+	UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+
+	if (!NetDriver)
+	{
+		return;
+	}
+
+	//Active objects are what ServerReplicateActors walks every frame, dormant ones are skipped until flushed
+	const FNetworkObjectList& NetworkObjects = NetDriver->GetNetworkObjectList();
+
+	SET_DWORD_STAT(STAT_NetActorsConsidered, NetworkObjects.GetActiveObjects().Num());
+	SET_DWORD_STAT(STAT_NetActorsDormant, NetworkObjects.GetAllObjects().Num() - NetworkObjects.GetActiveObjects().Num());
+#endif
+}
 
 void ASGameMode::ResetAllKDA()
 {
@@ -37,6 +89,14 @@ void ASGameMode::EnableUnlimitedMags()
 void ASGameMode::PostLogin(APlayerController * NewPlayer)
 {
 	Super::PostLogin(NewPlayer);
+
+	//Scoreboard row from the start, PlayerId is assigned by now
+	ASPlayerState* PS = Cast<ASPlayerState>(NewPlayer->PlayerState);
+
+	if (PS)
+	{
+		PS->UpdateScoreboard();
+	}
 	
 	ASPlayerController* PC = Cast<ASPlayerController>(NewPlayer);
 
@@ -49,49 +109,171 @@ void ASGameMode::PostLogin(APlayerController * NewPlayer)
 		if (NewCharacter) 
 		{
 			NewCharacter->OnDeath.AddDynamic(this, &ASGameMode::OnPlayerCharacterDeath);
+			LivingCharacters.AddUnique(NewCharacter);
 		}
 
 		PC->ClientRequestNetUserData();
 	}
 }
 
-AActor * ASGameMode::ChoseBestRespawnPlayerStart(AController* Player)
+void ASGameMode::HandleMatchHasStarted()
 {
-	UWorld* World = GetWorld();
-	APlayerStart* BestStart = nullptr;
-	float MinScore = TNumericLimits<float>::Max();
+	Super::HandleMatchHasStarted();
 
-	TArray<AActor*> Characters;
-		
-	UGameplayStatics::GetAllActorsOfClass( this, ASCharacter::StaticClass(), Characters);
+	CachePlayerStarts();
+	ActorPoolComp->Prewarm();
 
+	FSCombatEventRecorder::Get().BeginMatch(GetWorld()->GetMapName());
+}
+
+void ASGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FSCombatEventRecorder::Get().EndMatch();
+
+	Super::EndPlay(EndPlayReason);
+}
 
+void ASGameMode::CachePlayerStarts()
+{
+	PlayerStarts.Reset();
 
-	for (TActorIterator<APlayerStart> It(World); It; ++It)
+	for (TActorIterator<APlayerStart> It(GetWorld()); It; ++It)
 	{
-		APlayerStart* PlayerStart = *It;
-		float Score = 0;
+		PlayerStarts.Add(*It);
+	}
 
-			for (size_t i = 0; i < Characters.Num(); i++)
-			{
-				float Dist = FVector::Distance(PlayerStart->GetActorLocation(), Characters[i]->GetActorLocation());
+	int32 PaddedNum = Align(PlayerStarts.Num(), 4);
 
-				Score += 1 / FMath::Sqrt(Dist);
+	PlayerStartX.SetNumZeroed(PaddedNum);
+	PlayerStartY.SetNumZeroed(PaddedNum);
+	PlayerStartZ.SetNumZeroed(PaddedNum);
 
-			}
+	for (int32 i = 0; i < PlayerStarts.Num(); i++)
+	{
+		FVector Location = PlayerStarts[i]->GetActorLocation();
+		PlayerStartX[i] = Location.X;
+		PlayerStartY[i] = Location.Y;
+		PlayerStartZ[i] = Location.Z;
+	}
+}
 
-		//UE_LOG(LogTemp, Log, TEXT("%s has a Score of: %f"), *PlayerStart->GetName(), Score);
-		if (Score < MinScore) 
+void ASGameMode::UpdateLivingCharacterSnapshot()
+{
+	if (LivingCharacterSnapshotFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	LivingCharacterSnapshotFrame = GFrameCounter;
+
+	LivingCharacters.RemoveAllSwap([](const TWeakObjectPtr<ASCharacter>& Character)
+	{
+		return !Character.IsValid() || !Character->GetHealthComponent()->IsAlive();
+	});
+
+	LivingCharacterX.Reset(LivingCharacters.Num());
+	LivingCharacterY.Reset(LivingCharacters.Num());
+	LivingCharacterZ.Reset(LivingCharacters.Num());
+
+	for (const TWeakObjectPtr<ASCharacter>& Character : LivingCharacters)
+	{
+		FVector Location = Character->GetActorLocation();
+		LivingCharacterX.Add(Location.X);
+		LivingCharacterY.Add(Location.Y);
+		LivingCharacterZ.Add(Location.Z);
+	}
+}
+
+void ASGameMode::AccumulateRespawnScores(const float* X, const float* Y, const float* Z, int32 Count, TArray<float, TAlignedHeapAllocator<16>>& InOutScores) const
+{
+	//Keeps a character standing right on a start from producing an infinite score
+	const VectorRegister MinDistSquared = VectorSetFloat1(1.0f);
+
+	for (int32 i = 0; i < InOutScores.Num(); i += 4)
+	{
+		VectorRegister StartX = VectorLoadAligned(&PlayerStartX[i]);
+		VectorRegister StartY = VectorLoadAligned(&PlayerStartY[i]);
+		VectorRegister StartZ = VectorLoadAligned(&PlayerStartZ[i]);
+		VectorRegister Score = VectorLoadAligned(&InOutScores[i]);
+
+		for (int32 j = 0; j < Count; j++)
 		{
-			MinScore = Score;
-			BestStart = PlayerStart;
+			VectorRegister DX = VectorSubtract(StartX, VectorLoadFloat1(&X[j]));
+			VectorRegister DY = VectorSubtract(StartY, VectorLoadFloat1(&Y[j]));
+			VectorRegister DZ = VectorSubtract(StartZ, VectorLoadFloat1(&Z[j]));
+
+			VectorRegister DistSquared = VectorMultiplyAdd(DX, DX, VectorMultiplyAdd(DY, DY, VectorMultiply(DZ, DZ)));
+			DistSquared = VectorMax(DistSquared, MinDistSquared);
+
+			//1/sqrt(Dist) from the squared distance: Dist = DistSquared * rsqrt(DistSquared), then one more rsqrt
+			VectorRegister Dist = VectorMultiply(DistSquared, VectorReciprocalSqrt(DistSquared));
+			Score = VectorAdd(Score, VectorReciprocalSqrt(Dist));
 		}
+
+		VectorStoreAligned(Score, &InOutScores[i]);
+	}
+}
+
+AActor * ASGameMode::ChoseBestRespawnPlayerStart(AController* Player)
+{
+	TArray<AController*> Players;
+	Players.Add(Player);
+
+	TArray<AActor*> BestStarts;
+	ChoseBestRespawnPlayerStarts(Players, BestStarts);
+
+	return BestStarts[0];
+}
+
+void ASGameMode::ChoseBestRespawnPlayerStarts(const TArray<AController*>& Players, TArray<AActor*>& OutPlayerStarts)
+{
+	COOP_HOT_PATH_SCOPE(RespawnScoring);
+
+	OutPlayerStarts.Reset(Players.Num());
+
+	if (PlayerStarts.Num() == 0)
+	{
+		CachePlayerStarts();
 	}
 
+	UpdateLivingCharacterSnapshot();
+
+	TArray<float, TAlignedHeapAllocator<16>> Scores;
+	Scores.SetNumZeroed(PlayerStartX.Num());
+
+	AccumulateRespawnScores(LivingCharacterX.GetData(), LivingCharacterY.GetData(), LivingCharacterZ.GetData(), LivingCharacterX.Num(), Scores);
+
+	TBitArray<> Taken(false, PlayerStarts.Num());
+
+	for (int32 PlayerIndex = 0; PlayerIndex < Players.Num(); PlayerIndex++)
+	{
+		int32 BestIndex = INDEX_NONE;
+		float MinScore = TNumericLimits<float>::Max();
+
+		for (int32 i = 0; i < PlayerStarts.Num(); i++)
+		{
+			//Only share a start when there are more respawns than starts
+			bool bAvailable = !Taken[i] || PlayerIndex >= PlayerStarts.Num();
+
+			if (bAvailable && Scores[i] < MinScore && PlayerStarts[i])
+			{
+				MinScore = Scores[i];
+				BestIndex = i;
+			}
+		}
 
+		if (BestIndex == INDEX_NONE)
+		{
+			OutPlayerStarts.Add(nullptr);
+			continue;
+		}
 
-	return BestStart;
+		Taken[BestIndex] = true;
+		OutPlayerStarts.Add(PlayerStarts[BestIndex]);
 
+		//The picked start is about to hold a character, later picks in this batch keep away from it too
+		AccumulateRespawnScores(&PlayerStartX[BestIndex], &PlayerStartY[BestIndex], &PlayerStartZ[BestIndex], 1, Scores);
+	}
 }
 
 void ASGameMode::SetPlayerName(FString NewName, APlayerState * PlayerState)
@@ -119,10 +301,17 @@ void ASGameMode::SetPlayerMaterialFromId(int MatId, APlayerState * PlayerState)
 
 void ASGameMode::RestartPlayer(AController * NewPlayer)
 {
-	AActor* PlayerStart = nullptr;
-	PlayerStart = ChoseBestRespawnPlayerStart(NewPlayer);
+	SpawnPlayerAt(NewPlayer, ChoseBestRespawnPlayerStart(NewPlayer));
+}
 
-	UClass* PawnClass = GetDefaultPawnClassForController(NewPlayer);
+void ASGameMode::SpawnPlayerAt(AController * Player, AActor * PlayerStart)
+{
+	if (!PlayerStart)
+	{
+		return;
+	}
+
+	UClass* PawnClass = GetDefaultPawnClassForController(Player);
 
 	FActorSpawnParameters SpawnParameters;
 	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
@@ -131,23 +320,148 @@ void ASGameMode::RestartPlayer(AController * NewPlayer)
 	FRotator NewSpawnRotator = PlayerStart->GetActorRotation();
 
 	APawn* SpawnedActor = GetWorld()->SpawnActor<APawn>(PawnClass, NewSpawnLocation, NewSpawnRotator, SpawnParameters);
-	NewPlayer->Possess(SpawnedActor);
+	FSHotPathStats::AddCount(ESHotPathCounter::ActorsSpawned);
+	Player->Possess(SpawnedActor);
+
+	FSCombatEventRecorder::Get().Record(ESCombatEventType::Respawn, GetWorld()->GetTimeSeconds(), FSCombatEventRecorder::GetActorId(Player), -1, NewSpawnLocation);
 }
 
 void ASGameMode::RestartPlayerDelayed(AController * Player, float Delay)
 {
-	FTimerHandle UniqueHandle;
-	FTimerDelegate RespawnDelegate = FTimerDelegate::CreateUObject(this, &ASGameMode::RestartPlayerInProgress, Player);
+	FSPendingRespawn* Existing = RespawnQueue.FindByPredicate([Player](const FSPendingRespawn& Pending)
+	{
+		return Pending.Controller == Player;
+	});
+
+	if (Existing)
+	{
+		return;
+	}
 
-	GetWorldTimerManager().SetTimer(UniqueHandle, RespawnDelegate, Delay, false);
+	FSPendingRespawn Pending;
+	Pending.Controller = Player;
+	Pending.DueTime = GetWorld()->GetTimeSeconds() + Delay;
+
+	//Keep the queue ordered by due time so the budget always serves the longest waiting players first
+	int32 InsertIndex = RespawnQueue.Num();
+	while (InsertIndex > 0 && RespawnQueue[InsertIndex - 1].DueTime > Pending.DueTime)
+	{
+		InsertIndex--;
+	}
+
+	RespawnQueue.Insert(Pending, InsertIndex);
 }
 
-void ASGameMode::RestartPlayerInProgress(AController * Player)
+void ASGameMode::ProcessRespawnQueue()
 {
-	if (MatchState == MatchState::InProgress)
+	float Now = GetWorld()->GetTimeSeconds();
+
+	int32 DueCount = 0;
+	while (DueCount < RespawnQueue.Num() && RespawnQueue[DueCount].DueTime <= Now)
 	{
-		RestartPlayer(Player);
+		DueCount++;
+	}
+
+	if (DueCount == 0)
+	{
+		return;
+	}
+
+	//Same as a timer firing outside of the match, due respawns are dropped
+	if (MatchState != MatchState::InProgress)
+	{
+		RespawnQueue.RemoveAt(0, DueCount);
+		return;
+	}
+
+	TArray<AController*> Players;
+	int32 Consumed = 0;
+
+	while (Consumed < DueCount && Players.Num() < MaxRespawnsPerFrame)
+	{
+		AController* Player = RespawnQueue[Consumed].Controller.Get();
+		Consumed++;
+
+		if (Player && !Player->GetPawn())
+		{
+			Players.Add(Player);
+		}
+	}
+
+	RespawnQueue.RemoveAt(0, Consumed);
+
+	if (Players.Num() == 0)
+	{
+		return;
 	}
+
+	TArray<AActor*> Starts;
+	ChoseBestRespawnPlayerStarts(Players, Starts);
+
+	for (int32 i = 0; i < Players.Num(); i++)
+	{
+		SpawnPlayerAt(Players[i], Starts[i]);
+	}
+}
+
+void ASGameMode::RegisterLagCompensation(USLagCompensationComponent * Comp)
+{
+	LagCompensatedComponents.AddUnique(Comp);
+}
+
+void ASGameMode::UnregisterLagCompensation(USLagCompensationComponent * Comp)
+{
+	LagCompensatedComponents.RemoveSwap(Comp);
+}
+
+const TArray<USLagCompensationComponent*>& ASGameMode::GetLagCompensatedComponents() const
+{
+	return LagCompensatedComponents;
+}
+
+FSPickupGrid& ASGameMode::GetPickupGrid()
+{
+	return PickupGrid;
+}
+
+USActorPoolComponent * ASGameMode::GetActorPool() const
+{
+	return ActorPoolComp;
+}
+
+void ASGameMode::DumpActorPool()
+{
+	ActorPoolComp->DumpStats();
+}
+
+void ASGameMode::SpawnBenchmarkWeapons(int32 Count)
+{
+	TActorIterator<ASWeapon> It(GetWorld());
+
+	if (!It || PlayerStarts.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SpawnBenchmarkWeapons: needs a weapon in the world and a started match"));
+		return;
+	}
+
+	TSubclassOf<ASWeapon> WeaponClass = It->GetClass();
+
+	for (int32 i = 0; i < Count; i++)
+	{
+		AActor* Start = PlayerStarts[i % PlayerStarts.Num()];
+		FVector Offset = FVector(FMath::FRandRange(-300, 300), FMath::FRandRange(-300, 300), 100);
+
+		ASWeapon* Weapon = ActorPoolComp->Acquire<ASWeapon>(WeaponClass, FTransform(Start->GetActorLocation() + Offset), this);
+
+		//Same path as a character dropping it: physics, despawn timer and the dropped net state
+		if (Weapon)
+		{
+			Weapon->GetEquippedBy(this);
+			Weapon->Unequip();
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("SpawnBenchmarkWeapons: dropped %d %s, compare 'stat net' and 'stat CoopLearning' before and after they settle"), Count, *WeaponClass->GetName());
 }
 
 void ASGameMode::OnPlayerPossesWithAuthority(ASPlayerController * PC, APawn * NewPawn)
@@ -157,11 +471,16 @@ void ASGameMode::OnPlayerPossesWithAuthority(ASPlayerController * PC, APawn * Ne
 	if (NewCharacter)
 	{
 		NewCharacter->OnDeath.AddDynamic(this, &ASGameMode::OnPlayerCharacterDeath);
+		LivingCharacters.AddUnique(NewCharacter);
 	}
 }
 
 void ASGameMode::OnPlayerCharacterDeath(ASCharacter * Character, AController * InstigatedBy, AActor * DamageCauser)
 {
+	LivingCharacters.RemoveSwap(Character);
+
+	FSCombatEventRecorder::Get().Record(ESCombatEventType::Death, GetWorld()->GetTimeSeconds(), FSCombatEventRecorder::GetActorId(InstigatedBy), FSCombatEventRecorder::GetActorId(Character), Character->GetActorLocation());
+
 	ASPlayerController* PC = Cast<ASPlayerController>(Character->Controller);
 
 	if (!PC) 
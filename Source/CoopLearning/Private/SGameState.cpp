@@ -3,20 +3,154 @@
 
 #include "SGameState.h"
 #include "SPlayerState.h"
+#include "Components/SEffectPoolComponent.h"
+#include "Components/SAudioDispatchComponent.h"
+#include "Components/SFireSchedulerComponent.h"
+#include "Components/SExplosionResolverComponent.h"
+#include "Net/UnrealNetwork.h"
+#include "SHotPathStats.h"
+
+ASGameState::ASGameState()
+{
+	EffectPoolComp = CreateDefaultSubobject<USEffectPoolComponent>(TEXT("EffectPoolComp"));
+	AudioDispatchComp = CreateDefaultSubobject<USAudioDispatchComponent>(TEXT("AudioDispatchComp"));
+	FireSchedulerComp = CreateDefaultSubobject<USFireSchedulerComponent>(TEXT("FireSchedulerComp"));
+	ExplosionResolverComp = CreateDefaultSubobject<USExplosionResolverComponent>(TEXT("ExplosionResolverComp"));
+
+	CachedPlayersInfoVersion = -1;
+}
+
+void ASGameState::BeginPlay()
+{
+	Super::BeginPlay();
+
+	//On every machine, so clients can dump their own hot path percentiles too
+	FSHotPathStats::ResetMatch();
+}
+
+USEffectPoolComponent * ASGameState::GetEffectPool() const
+{
+	return EffectPoolComp;
+}
+
+USAudioDispatchComponent * ASGameState::GetAudioDispatch() const
+{
+	return AudioDispatchComp;
+}
+
+USFireSchedulerComponent * ASGameState::GetFireScheduler() const
+{
+	return FireSchedulerComp;
+}
+
+USExplosionResolverComponent * ASGameState::GetExplosionResolver() const
+{
+	return ExplosionResolverComp;
+}
 
 FString ASGameState::GetAllPlayersInfo()
 {
-	FString Content;
+	if (CachedPlayersInfoVersion == Scoreboard.GetVersion())
+	{
+		return CachedPlayersInfo;
+	}
+
+	CachedPlayersInfo.Reset();
+
+	for (int32 PlayerId : Scoreboard.GetRanking())
+	{
+		const FSScoreboardRow* Row = Scoreboard.FindRow(PlayerId);
+
+		if (Row)
+		{
+			CachedPlayersInfo.Append(FormatScoreboardRow(*Row));
+			CachedPlayersInfo.Append(TEXT(" \n "));
+		}
+	}
+
+	CachedPlayersInfoVersion = Scoreboard.GetVersion();
+
+	return CachedPlayersInfo;
+}
+
+void ASGameState::UpdateScoreboard(APlayerState* PlayerState, int32 Kills, int32 Deaths, int32 KillsInARow, int32 DeathInARow)
+{
+	Scoreboard.SetScore(PlayerState->PlayerId, Kills, Deaths, KillsInARow, DeathInARow);
+	ForceNetUpdate();
+}
+
+void ASGameState::AddPlayerState(APlayerState* PlayerState)
+{
+	Super::AddPlayerState(PlayerState);
+
+	//On clients the row often arrived before its PlayerState
+	MarkScoreboardNamesChanged();
+}
+
+void ASGameState::MarkScoreboardNamesChanged()
+{
+	Scoreboard.MarkAllRowsChanged();
+}
+
+void ASGameState::RemovePlayerState(APlayerState* PlayerState)
+{
+	Super::RemovePlayerState(PlayerState);
+
+	MarkScoreboardNamesChanged();
+
+	if (Role >= ROLE_Authority)
+	{
+		Scoreboard.RemovePlayer(PlayerState->PlayerId);
+	}
+}
+
+int32 ASGameState::GetScoreboardVersion() const
+{
+	return Scoreboard.GetVersion();
+}
+
+TArray<FSScoreboardRow> ASGameState::GetScoreboardRows() const
+{
+	TArray<FSScoreboardRow> Result;
+	Result.Reserve(Scoreboard.GetRanking().Num());
 
-	for (int i = 0; i < PlayerArray.Num(); i++)
+	for (int32 PlayerId : Scoreboard.GetRanking())
 	{
-		ASPlayerState* PlayerState = Cast<ASPlayerState>(PlayerArray[i]);
+		const FSScoreboardRow* Row = Scoreboard.FindRow(PlayerId);
 
-		Content.Append(PlayerState->GetPlayerInfo());
-		Content.Append(" \n ");
+		if (Row)
+		{
+			Result.Add(*Row);
+		}
+	}
+
+	return Result;
+}
 
+APlayerState* ASGameState::FindPlayerStateById(int32 PlayerId) const
+{
+	for (APlayerState* PlayerState : PlayerArray)
+	{
+		if (PlayerState && PlayerState->PlayerId == PlayerId)
+		{
+			return PlayerState;
+		}
 	}
 
-	return Content;
+	return nullptr;
+}
+
+FString ASGameState::FormatScoreboardRow(const FSScoreboardRow& Row) const
+{
+	APlayerState* PlayerState = FindPlayerStateById(Row.PlayerId);
+	FString Name = PlayerState ? PlayerState->GetPlayerName() : FString();
+
+	return FString::Printf(TEXT("%s (K: %d  | D: %d)"), *Name, Row.Kills, Row.Deaths);
 }
 
+void ASGameState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ASGameState, Scoreboard);
+}
@@ -13,6 +13,13 @@
 #include "GameFramework/Actor.h"
 #include "Net/UnrealNetwork.h"
 #include "GameFramework/Character.h"
+#include "TimerManager.h"
+#include "SGameMode.h"
+#include "Components/SActorPoolComponent.h"
+#include "Components/SAudioDispatchComponent.h"
+#include "Components/SExplosionResolverComponent.h"
+#include "SGameState.h"
+#include "SHotPathStats.h"
 
 // Sets default values
 ASGranade::ASGranade()
@@ -35,6 +42,8 @@ ASGranade::ASGranade()
 
 	ExplosionImpulse = 400;
 	ExplosionDefaultTime = 5;
+	ThrowCount = 0;
+	bExploded = false;
 
 	SetReplicates(true);
 
@@ -44,15 +53,46 @@ ASGranade::ASGranade()
 void ASGranade::BeginPlay()
 {
 	Super::BeginPlay();
-	
-	if (Role <= ROLE_Authority) 
+}
+
+void ASGranade::OnAcquiredFromPool()
+{
+	if (Role < ROLE_Authority)
 	{
-		GetWorldTimerManager().SetTimer(TimerHandle_DefaultExplosion, this, &ASGranade::DefaultExplode, ExplosionDefaultTime, true);
+		return;
 	}
 
+	bExploded = false;
+	HealthComp->ResetHealth();
+
+	MeshComp->SetSimulatePhysics(true);
+	MeshComp->SetPhysicsLinearVelocity(FVector::ZeroVector);
+	MeshComp->SetPhysicsAngularVelocity(FVector::ZeroVector);
+
+	GetWorldTimerManager().SetTimer(TimerHandle_DefaultExplosion, this, &ASGranade::DefaultExplode, ExplosionDefaultTime, false);
+
+	ThrowCount++;
+	PlaySpawnSound();
+}
+
+void ASGranade::OnReleasedToPool()
+{
+	GetWorldTimerManager().ClearTimer(TimerHandle_DefaultExplosion);
+	GetWorldTimerManager().ClearTimer(TimerHandle_Release);
+
+	MeshComp->SetSimulatePhysics(false);
+}
+
+void ASGranade::OnRep_ThrowCount()
+{
+	PlaySpawnSound();
+}
+
+void ASGranade::PlaySpawnSound()
+{
 	if (SpawnSound)
 	{
-		UGameplayStatics::PlaySoundAtLocation(GetWorld(), SpawnSound, GetActorLocation(), 1, 1, 0, SoundAttenuation);
+		USAudioDispatchComponent::PlaySoundAtLocation(this, SpawnSound, GetActorLocation(), ESSoundCategory::Misc, SoundAttenuation);
 	}
 }
 
@@ -82,15 +122,46 @@ void ASGranade::DefaultExplode()
 
 void ASGranade::Explode(AController* InstigatedBy)
 {
-	TArray<AActor*> IgnoredActors;
-	IgnoredActors.Add(this);
+	//Damage from its own blast or a late timer must not set it off twice
+	if (bExploded)
+	{
+		return;
+	}
 
-	UGameplayStatics::ApplyRadialDamage(GetWorld(), ExplosionDamage, GetActorLocation(), RadialForceComp->Radius, ExplosionDamageType, IgnoredActors, this, InstigatedBy, true);
+	bExploded = true;
+	GetWorldTimerManager().ClearTimer(TimerHandle_DefaultExplosion);
 
-	RadialForceComp->FireImpulse();
-	MulticastExplode();
+	ASGameState* GS = GetWorld()->GetGameState<ASGameState>();
 
-	SetLifeSpan(0.05f);
+	if (GS)
+	{
+		FSExplosion Explosion;
+		Explosion.Origin = GetActorLocation();
+		Explosion.SetImpulseFrom(RadialForceComp);
+		Explosion.Damage = ExplosionDamage;
+		Explosion.DamageType = ExplosionDamageType;
+		Explosion.Source = this;
+		Explosion.DamageCauser = this;
+		Explosion.InstigatedBy = InstigatedBy;
+
+		GS->GetExplosionResolver()->Explode(Explosion);
+	}
+
+	GetWorldTimerManager().SetTimer(TimerHandle_Release, this, &ASGranade::ReleaseToPool, 0.05f, false);
+}
+
+void ASGranade::ReleaseToPool()
+{
+	ASGameMode* GM = GetWorld()->GetAuthGameMode<ASGameMode>();
+
+	if (GM)
+	{
+		GM->GetActorPool()->Release(this);
+	}
+	else
+	{
+		Destroy();
+	}
 }
 
 UStaticMeshComponent * ASGranade::GetMeshComp()
@@ -99,15 +170,23 @@ UStaticMeshComponent * ASGranade::GetMeshComp()
 }
 
 
-void ASGranade::MulticastExplode_Implementation()
+void ASGranade::PlayExplosionEffects(const FVector& Location)
 {
 	if (ExplosionEffect)
 	{
-		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ExplosionEffect, GetActorLocation(), FRotator::ZeroRotator);
+		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ExplosionEffect, Location, FRotator::ZeroRotator);
+		FSHotPathStats::AddCount(ESHotPathCounter::EffectsSpawned);
 	}
 
 	if (ExplosionSound)
 	{
-		UGameplayStatics::PlaySoundAtLocation(GetWorld(), ExplosionSound, GetActorLocation(), 1, 1, 0, SoundAttenuation);
+		USAudioDispatchComponent::PlaySoundAtLocation(this, ExplosionSound, Location, ESSoundCategory::Explosion, SoundAttenuation);
 	}
-}
\ No newline at end of file
+}
+
+void ASGranade::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ASGranade, ThrowCount);
+}
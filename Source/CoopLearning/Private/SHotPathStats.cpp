@@ -0,0 +1,200 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SHotPathStats.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+
+CSV_DEFINE_CATEGORY(CoopLearning, true);
+
+DEFINE_STAT(STAT_CoopWeaponFire);
+DEFINE_STAT(STAT_CoopPelletTraces);
+DEFINE_STAT(STAT_CoopCharacterTick);
+DEFINE_STAT(STAT_CoopRespawnScoring);
+DEFINE_STAT(STAT_CoopExplosions);
+DEFINE_STAT(STAT_CoopEffectSpawns);
+DEFINE_STAT(STAT_CoopSoundDispatch);
+DEFINE_STAT(STAT_CoopFireScheduler);
+DEFINE_STAT(STAT_CoopLagCompensation);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Traces"), STAT_CoopTraces, STATGROUP_CoopLearning);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Weapon RPCs"), STAT_CoopWeaponRPCs, STATGROUP_CoopLearning);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Character RPCs"), STAT_CoopCharacterRPCs, STATGROUP_CoopLearning);
+DECLARE_DWORD_COUNTER_STAT(TEXT("GameState RPCs"), STAT_CoopGameStateRPCs, STATGROUP_CoopLearning);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Actors Spawned"), STAT_CoopActorsSpawned, STATGROUP_CoopLearning);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Effects Spawned"), STAT_CoopEffectsSpawned, STATGROUP_CoopLearning);
+
+namespace
+{
+	const TCHAR* HotPathNames[] = { TEXT("WeaponFire"), TEXT("PelletTraces"), TEXT("CharacterTick"), TEXT("RespawnScoring"), TEXT("Explosions"), TEXT("EffectSpawns"), TEXT("SoundDispatch"), TEXT("FireScheduler"), TEXT("LagCompensation") };
+
+	const TCHAR* CounterNames[] = { TEXT("Traces"), TEXT("WeaponRPCs"), TEXT("CharacterRPCs"), TEXT("GameStateRPCs"), TEXT("ActorsSpawned"), TEXT("EffectsSpawned") };
+
+	static_assert(ARRAY_COUNT(HotPathNames) == (int32)ESHotPath::Count, "Name every hot path");
+	static_assert(ARRAY_COUNT(CounterNames) == (int32)ESHotPathCounter::Count, "Name every counter");
+
+	//Four buckets per doubling, the last one catches everything above
+	const int32 BucketCount = 128;
+
+	struct FSHistogram
+	{
+		uint32 Buckets[BucketCount];
+
+		uint32 Frames;
+
+		double Sum;
+
+		double Max;
+
+		void Reset()
+		{
+			FMemory::Memzero(Buckets);
+			Frames = 0;
+			Sum = 0;
+			Max = 0;
+		}
+
+		void Add(double Value)
+		{
+			int32 Bucket = FMath::Clamp((int32)(FMath::Log2(1.0 + Value) * 4.0), 0, BucketCount - 1);
+			Buckets[Bucket]++;
+			Frames++;
+			Sum += Value;
+			Max = FMath::Max(Max, Value);
+		}
+
+		//Upper edge of the bucket holding the percentile, within a fifth of the real value
+		double GetPercentile(double Percentile) const
+		{
+			uint32 Rank = (uint32)FMath::CeilToDouble(Frames * Percentile);
+			uint32 Seen = 0;
+
+			for (int32 i = 0; i < BucketCount; i++)
+			{
+				Seen += Buckets[i];
+
+				if (Seen >= Rank && Seen > 0)
+				{
+					return FMath::Min(FMath::Pow(2.0, (i + 1) / 4.0) - 1.0, Max);
+				}
+			}
+
+			return Max;
+		}
+	};
+
+	//Microseconds
+	FSHistogram PathHistograms[(int32)ESHotPath::Count];
+
+	FSHistogram CounterHistograms[(int32)ESHotPathCounter::Count];
+
+	uint32 FrameCycles[(int32)ESHotPath::Count];
+
+	int32 FrameCounts[(int32)ESHotPathCounter::Count];
+
+	FDelegateHandle EndFrameHandle;
+
+	void OnEndFrame()
+	{
+		for (int32 i = 0; i < (int32)ESHotPath::Count; i++)
+		{
+			PathHistograms[i].Add(FPlatformTime::ToMilliseconds(FrameCycles[i]) * 1000.0);
+			FrameCycles[i] = 0;
+		}
+
+		int32 Counts[(int32)ESHotPathCounter::Count];
+
+		for (int32 i = 0; i < (int32)ESHotPathCounter::Count; i++)
+		{
+			Counts[i] = FPlatformAtomics::InterlockedExchange(&FrameCounts[i], 0);
+			CounterHistograms[i].Add(Counts[i]);
+		}
+
+		SET_DWORD_STAT(STAT_CoopTraces, Counts[(int32)ESHotPathCounter::Traces]);
+		SET_DWORD_STAT(STAT_CoopWeaponRPCs, Counts[(int32)ESHotPathCounter::WeaponRPCs]);
+		SET_DWORD_STAT(STAT_CoopCharacterRPCs, Counts[(int32)ESHotPathCounter::CharacterRPCs]);
+		SET_DWORD_STAT(STAT_CoopGameStateRPCs, Counts[(int32)ESHotPathCounter::GameStateRPCs]);
+		SET_DWORD_STAT(STAT_CoopActorsSpawned, Counts[(int32)ESHotPathCounter::ActorsSpawned]);
+		SET_DWORD_STAT(STAT_CoopEffectsSpawned, Counts[(int32)ESHotPathCounter::EffectsSpawned]);
+
+		CSV_CUSTOM_STAT(CoopLearning, Traces, Counts[(int32)ESHotPathCounter::Traces], ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(CoopLearning, WeaponRPCs, Counts[(int32)ESHotPathCounter::WeaponRPCs], ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(CoopLearning, CharacterRPCs, Counts[(int32)ESHotPathCounter::CharacterRPCs], ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(CoopLearning, GameStateRPCs, Counts[(int32)ESHotPathCounter::GameStateRPCs], ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(CoopLearning, ActorsSpawned, Counts[(int32)ESHotPathCounter::ActorsSpawned], ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(CoopLearning, EffectsSpawned, Counts[(int32)ESHotPathCounter::EffectsSpawned], ECsvCustomStatOp::Set);
+	}
+
+	void DumpHistogram(const TCHAR* Name, const FSHistogram& Histogram, const TCHAR* Unit, double Scale)
+	{
+		if (Histogram.Frames == 0)
+		{
+			return;
+		}
+
+		UE_LOG(LogTemp, Log, TEXT("  %-16s mean %8.3f  p50 %8.3f  p90 %8.3f  p99 %8.3f  max %8.3f %s"), Name,
+			Histogram.Sum / Histogram.Frames * Scale, Histogram.GetPercentile(0.5) * Scale, Histogram.GetPercentile(0.9) * Scale,
+			Histogram.GetPercentile(0.99) * Scale, Histogram.Max * Scale, Unit);
+	}
+}
+
+void FSHotPathStats::ResetMatch()
+{
+	check(IsInGameThread());
+
+	for (FSHistogram& Histogram : PathHistograms)
+	{
+		Histogram.Reset();
+	}
+
+	for (FSHistogram& Histogram : CounterHistograms)
+	{
+		Histogram.Reset();
+	}
+
+	FMemory::Memzero(FrameCycles);
+	FMemory::Memzero(FrameCounts);
+
+	if (!EndFrameHandle.IsValid())
+	{
+		EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&OnEndFrame);
+	}
+}
+
+void FSHotPathStats::AddCycles(ESHotPath Path, uint32 Cycles)
+{
+	FrameCycles[(int32)Path] += Cycles;
+}
+
+void FSHotPathStats::AddCount(ESHotPathCounter Counter, int32 Amount)
+{
+	FPlatformAtomics::InterlockedAdd(&FrameCounts[(int32)Counter], Amount);
+}
+
+void FSHotPathStats::Dump()
+{
+	UE_LOG(LogTemp, Log, TEXT("CoopHotPathStats: %u frames this match, game thread time per frame"), PathHistograms[0].Frames);
+
+	for (int32 i = 0; i < (int32)ESHotPath::Count; i++)
+	{
+		DumpHistogram(HotPathNames[i], PathHistograms[i], TEXT("ms"), 0.001);
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("CoopHotPathStats: counts per frame"));
+
+	for (int32 i = 0; i < (int32)ESHotPathCounter::Count; i++)
+	{
+		DumpHistogram(CounterNames[i], CounterHistograms[i], TEXT(""), 1.0);
+	}
+}
+
+static void DumpHotPathStats(const TArray<FString>& Args)
+{
+	FSHotPathStats::Dump();
+
+	if (Args.Num() > 0 && Args[0] == TEXT("reset"))
+	{
+		FSHotPathStats::ResetMatch();
+	}
+}
+
+FAutoConsoleCommand DumpHotPathStatsCommand(TEXT("CoopHotPathStats"), TEXT("CoopHotPathStats [reset], p50/p90/p99/max per frame of every gameplay hot path and counter since the match started"), FConsoleCommandWithArgsDelegate::CreateStatic(&DumpHotPathStats));
@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SPickupGrid.h"
+#include "HAL/IConsoleManager.h"
+
+//Nearest pickup queries against the grid compared to scanning every pickup, the cost each character paid for discovering pickups on its own
+static void BenchmarkPickupGrid(const TArray<FString>& Args)
+{
+	int32 PickupCount = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 10000;
+	int32 QuerierCount = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 64;
+	int32 FrameCount = Args.Num() > 2 ? FCString::Atoi(*Args[2]) : 100;
+	const float WorldExtent = 20000.0f;
+	const float PickupRadius = 300.0f;
+
+	FRandomStream Random(1234);
+	TSPickupGrid<int32> Grid;
+	TArray<FVector> PickupLocations;
+
+	for (int32 i = 0; i < PickupCount; i++)
+	{
+		FVector Location(Random.FRandRange(-WorldExtent, WorldExtent), Random.FRandRange(-WorldExtent, WorldExtent), 0);
+		PickupLocations.Add(Location);
+		Grid.Add(i + 1, Location);
+	}
+
+	TArray<FVector> Queriers;
+
+	for (int32 i = 0; i < QuerierCount; i++)
+	{
+		Queriers.Add(FVector(Random.FRandRange(-WorldExtent, WorldExtent), Random.FRandRange(-WorldExtent, WorldExtent), 0));
+	}
+
+	int32 GridFound = 0;
+	double StartTime = FPlatformTime::Seconds();
+
+	for (int32 Frame = 0; Frame < FrameCount; Frame++)
+	{
+		for (const FVector& Querier : Queriers)
+		{
+			GridFound += Grid.FindNearest(Querier, PickupRadius, [](int32) { return true; }) != 0 ? 1 : 0;
+		}
+	}
+
+	double GridTime = FPlatformTime::Seconds() - StartTime;
+
+	int32 ScanFound = 0;
+	StartTime = FPlatformTime::Seconds();
+
+	for (int32 Frame = 0; Frame < FrameCount; Frame++)
+	{
+		for (const FVector& Querier : Queriers)
+		{
+			float NearestDistSq = PickupRadius * PickupRadius;
+			int32 Nearest = INDEX_NONE;
+
+			for (int32 i = 0; i < PickupLocations.Num(); i++)
+			{
+				float DistSq = FVector::DistSquared(Querier, PickupLocations[i]);
+
+				if (DistSq <= NearestDistSq)
+				{
+					NearestDistSq = DistSq;
+					Nearest = i;
+				}
+			}
+
+			ScanFound += Nearest != INDEX_NONE ? 1 : 0;
+		}
+	}
+
+	double ScanTime = FPlatformTime::Seconds() - StartTime;
+	int32 QueryCount = FMath::Max(QuerierCount * FrameCount, 1);
+
+	UE_LOG(LogTemp, Log, TEXT("Pickup grid: %d pickups, %d queriers, %d frames. Grid %.3f us per query (%d found), linear scan %.3f us per query (%d found)"), PickupCount, QuerierCount, FrameCount, GridTime * 1000000.0 / QueryCount, GridFound, ScanTime * 1000000.0 / QueryCount, ScanFound);
+}
+
+FAutoConsoleCommand BenchmarkPickupGridCommand(TEXT("BenchmarkPickupGrid"), TEXT("BenchmarkPickupGrid [Pickups=10000] [Queriers=64] [Frames=100]"), FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkPickupGrid));
@@ -2,12 +2,22 @@
 
 #include "SPlayerState.h"
 #include "Net/UnrealNetwork.h"
+#include "SGameState.h"
+
+ASPlayerState::ASPlayerState()
+{
+	//Score and material only change at the write sites below, which force an update. The rate only keeps ping fresh
+	NetUpdateFrequency = 0.5f;
+}
 
 void ASPlayerState::AddKill()
 {
 	Kills += 1;
 	KillsInARow += 1;
 	DeathInARow = 0;
+
+	ForceNetUpdate();
+	UpdateScoreboard();
 }
 
 void ASPlayerState::AddDeath()
@@ -15,6 +25,9 @@ void ASPlayerState::AddDeath()
 	Deaths += 1;
 	DeathInARow += 1;
 	KillsInARow = 0;
+
+	ForceNetUpdate();
+	UpdateScoreboard();
 }
 
 int ASPlayerState::GetKills()
@@ -33,6 +46,9 @@ void ASPlayerState::Reset()
 	Kills = 0;
 	KillsInARow = 0;
 	DeathInARow = 0;
+
+	ForceNetUpdate();
+	UpdateScoreboard();
 }
 
 FString ASPlayerState::GetPlayerInfo()
@@ -43,11 +59,46 @@ FString ASPlayerState::GetPlayerInfo()
 void ASPlayerState::SetName(FString S)
 {
 	SetPlayerName(S);
+
+	//SetPlayerName only calls OnRep_PlayerName itself on listen servers and standalone
+	if (GetNetMode() == NM_DedicatedServer)
+	{
+		MarkScoreboardNameChanged();
+	}
+}
+
+void ASPlayerState::OnRep_PlayerName()
+{
+	Super::OnRep_PlayerName();
+
+	MarkScoreboardNameChanged();
+}
+
+void ASPlayerState::MarkScoreboardNameChanged()
+{
+	ASGameState* GS = GetWorld() ? GetWorld()->GetGameState<ASGameState>() : nullptr;
+
+	if (GS)
+	{
+		GS->MarkScoreboardNamesChanged();
+	}
 }
 
 void ASPlayerState::SetMaterialId(int NewMaterialId)
 {
 	MaterialId = NewMaterialId;
+
+	ForceNetUpdate();
+}
+
+void ASPlayerState::UpdateScoreboard()
+{
+	ASGameState* GS = GetWorld()->GetGameState<ASGameState>();
+
+	if (GS && Role >= ROLE_Authority)
+	{
+		GS->UpdateScoreboard(this, Kills, Deaths, KillsInARow, DeathInARow);
+	}
 }
 
 void ASPlayerState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SScoreboard.h"
+
+void FSScoreboardRow::PostReplicatedAdd(const FSScoreboard& InArraySerializer)
+{
+	RowVersion = InArraySerializer.OnRowChanged(*this);
+}
+
+void FSScoreboardRow::PostReplicatedChange(const FSScoreboard& InArraySerializer)
+{
+	RowVersion = InArraySerializer.OnRowChanged(*this);
+}
+
+void FSScoreboardRow::PreReplicatedRemove(const FSScoreboard& InArraySerializer)
+{
+	InArraySerializer.OnRowRemoved(PlayerId);
+}
+
+void FSScoreboard::SetScore(int32 PlayerId, int32 Kills, int32 Deaths, int32 KillsInARow, int32 DeathInARow)
+{
+	FSScoreboardRow* Row = Rows.FindByPredicate([PlayerId](const FSScoreboardRow& Other) { return Other.PlayerId == PlayerId; });
+
+	if (!Row)
+	{
+		Row = &Rows.AddDefaulted_GetRef();
+		Row->PlayerId = PlayerId;
+	}
+
+	Row->Kills = Kills;
+	Row->Deaths = Deaths;
+	Row->KillsInARow = KillsInARow;
+	Row->DeathInARow = DeathInARow;
+
+	MarkItemDirty(*Row);
+	Row->RowVersion = OnRowChanged(*Row);
+}
+
+void FSScoreboard::RemovePlayer(int32 PlayerId)
+{
+	int32 Index = Rows.IndexOfByPredicate([PlayerId](const FSScoreboardRow& Other) { return Other.PlayerId == PlayerId; });
+
+	if (Index != INDEX_NONE)
+	{
+		Rows.RemoveAtSwap(Index);
+		MarkArrayDirty();
+		OnRowRemoved(PlayerId);
+	}
+}
+
+const FSScoreboardRow* FSScoreboard::FindRow(int32 PlayerId) const
+{
+	return Rows.FindByPredicate([PlayerId](const FSScoreboardRow& Other) { return Other.PlayerId == PlayerId; });
+}
+
+bool FSScoreboard::IsRankedBefore(const FSScoreboardRow& A, const FSScoreboardRow& B) const
+{
+	if (A.Kills != B.Kills)
+	{
+		return A.Kills > B.Kills;
+	}
+
+	if (A.Deaths != B.Deaths)
+	{
+		return A.Deaths < B.Deaths;
+	}
+
+	return A.PlayerId < B.PlayerId;
+}
+
+const TArray<int32>& FSScoreboard::GetRanking() const
+{
+	if (bRankingDirty)
+	{
+		//Other rows of the same update may have been written after the callback of this one, only sort once all are in
+		Ranking.StableSort([this](int32 A, int32 B)
+		{
+			const FSScoreboardRow* RowA = FindRow(A);
+			const FSScoreboardRow* RowB = FindRow(B);
+
+			return RowA && (!RowB || IsRankedBefore(*RowA, *RowB));
+		});
+
+		bRankingDirty = false;
+	}
+
+	return Ranking;
+}
+
+void FSScoreboard::MarkAllRowsChanged()
+{
+	Version++;
+
+	for (FSScoreboardRow& Row : Rows)
+	{
+		Row.RowVersion = Version;
+	}
+}
+
+int32 FSScoreboard::OnRowChanged(const FSScoreboardRow& Row) const
+{
+	Ranking.AddUnique(Row.PlayerId);
+	bRankingDirty = true;
+
+	return ++Version;
+}
+
+void FSScoreboard::OnRowRemoved(int32 PlayerId) const
+{
+	Ranking.Remove(PlayerId);
+	Version++;
+}
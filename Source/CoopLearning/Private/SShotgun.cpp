@@ -2,16 +2,8 @@
 
 
 #include "SShotgun.h"
-#include "TimerManager.h"
-#include "Kismet/GameplayStatics.h"
 
-void ASShotgun::StartFire()
+int32 ASShotgun::GetPelletsPerShot() const
 {
-	float FirstDelay = FMath::Max(LastFireTimeStamp + TimeBetweenShots - GetWorld()->TimeSeconds, 0.0f);
-
-	FTimerDelegate ShotDelegate = FTimerDelegate::CreateUObject(this, &ASShotgun::Fire, PelletsPerShot);
-
-	GetWorldTimerManager().SetTimer(TimerHandle_TimeBetweenShots, ShotDelegate, TimeBetweenShots, true, FirstDelay);
+	return PelletsPerShot;
 }
-
-
@@ -9,18 +9,131 @@
 #include "PhysicalMaterials/PhysicalMaterial.h"
 #include "CoopLearning.h"
 #include "TimerManager.h"
-#include "Engine/DataTable.h"
-#include "UObject/ConstructorHelpers.h"
+#include "SWeaponRegistry.h"
 #include "Net/UnrealNetwork.h"
 #include "Sound/SoundCue.h"
 #include "Components/DecalComponent.h"
 #include "Engine/Engine.h"
 #include "SGameState.h"
+#include "SGameMode.h"
+#include "Components/SLagCompensationComponent.h"
+#include "Components/SActorPoolComponent.h"
+#include "Components/SEffectPoolComponent.h"
+#include "Components/SFireSchedulerComponent.h"
+#include "Async/ParallelFor.h"
+#include "Engine/NetSerialization.h"
+#include "UObject/CoreNet.h"
+#include "Engine/SkeletalMeshSocket.h"
+#include "Engine/SkeletalMesh.h"
+#include "EngineUtils.h"
+#include "HAL/PlatformTime.h"
+#include "Components/SAudioDispatchComponent.h"
+#include "SCombatEventRecorder.h"
+#include "SHotPathStats.h"
 
 static int32 DebugWeaponDrawing = 0;
 
 FAutoConsoleVariableRef CVARDegubWeaponDrawing (TEXT("DebugWeapons"), DebugWeaponDrawing, TEXT("Draw Debug Lines for Weapons"), ECVF_Cheat);
 
+static int32 ParallelPelletThreshold = 4;
+
+FAutoConsoleVariableRef CVARParallelPelletThreshold (TEXT("WeaponParallelPelletThreshold"), ParallelPelletThreshold, TEXT("Minimum pellets in a volley before its traces are spread over worker threads"), ECVF_Default);
+
+static int32 WeaponNetStats = 0;
+
+FAutoConsoleVariableRef CVARWeaponNetStats (TEXT("WeaponNetStats"), WeaponNetStats, TEXT("Measure the payload of every volley RPC, shown in stat CoopLearning"), ECVF_Default);
+
+static void BenchmarkWeaponSockets(const TArray<FString>& Args, UWorld* World)
+{
+	int32 Iterations = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 100000;
+
+	for (TActorIterator<ASWeapon> It(World); It; ++It)
+	{
+		It->BenchmarkSocketCache(Iterations);
+		return;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("BenchmarkWeaponSockets: no weapon in the world"));
+}
+
+FAutoConsoleCommandWithWorldAndArgs BenchmarkWeaponSocketsCommand(TEXT("BenchmarkWeaponSockets"), TEXT("BenchmarkWeaponSockets [Volleys=100000], socket lookups of the fire path by name vs cached"), FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&BenchmarkWeaponSockets));
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Volley RPC Bytes Per Shot"), STAT_VolleyBytesPerShot, STATGROUP_CoopLearning);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Per Pellet RPC Bytes Per Shot (old)"), STAT_PerPelletBytesPerShot, STATGROUP_CoopLearning);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Volley RPC Bytes Total"), STAT_VolleyBytesTotal, STATGROUP_CoopLearning);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Predicted Shot Index Mismatches"), STAT_ShotIndexMismatches, STATGROUP_CoopLearning);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Weapons Equipped"), STAT_WeaponsEquipped, STATGROUP_CoopLearning);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Weapons Dropped"), STAT_WeaponsDropped, STATGROUP_CoopLearning);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Weapons Idle"), STAT_WeaponsIdle, STATGROUP_CoopLearning);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Weapon Net Updates/s Saved Equipped"), STAT_WeaponUpdatesSavedEquipped, STATGROUP_CoopLearning);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Weapon Net Updates/s Saved Idle"), STAT_WeaponUpdatesSavedIdle, STATGROUP_CoopLearning);
+
+void FMulticastShotData::QuantizeAim()
+{
+	TraceStart = FVector(FMath::RoundToFloat(TraceStart.X), FMath::RoundToFloat(TraceStart.Y), FMath::RoundToFloat(TraceStart.Z));
+
+	AimRotation.Pitch = FRotator::DecompressAxisFromShort(FRotator::CompressAxisToShort(AimRotation.Pitch));
+	AimRotation.Yaw = FRotator::DecompressAxisFromShort(FRotator::CompressAxisToShort(AimRotation.Yaw));
+	AimRotation.Roll = 0;
+
+	SpreadAmount = FMath::RoundToFloat(FMath::Clamp(SpreadAmount, 0.0f, 1.0f) * MAX_uint16) / MAX_uint16;
+}
+
+bool FMulticastShotData::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+
+	uint8 NoShotBit = NoShot ? 1 : 0;
+	Ar.SerializeBits(&NoShotBit, 1);
+	NoShot = NoShotBit != 0;
+
+	if (NoShot)
+	{
+		return true;
+	}
+
+	uint32 PackedShotIndex = ShotIndex;
+	Ar.SerializeIntPacked(PackedShotIndex);
+	ShotIndex = PackedShotIndex;
+
+	bOutSuccess &= SerializePackedVector<1, 20>(TraceStart, Ar);
+
+	uint16 Pitch = FRotator::CompressAxisToShort(AimRotation.Pitch);
+	uint16 Yaw = FRotator::CompressAxisToShort(AimRotation.Yaw);
+	uint16 Spread = FMath::RoundToInt(FMath::Clamp(SpreadAmount, 0.0f, 1.0f) * MAX_uint16);
+	Ar << Pitch << Yaw << Spread;
+
+	uint32 PelletCount = Pellets.Num();
+	Ar.SerializeInt(PelletCount, MAX_PELLETS_PER_VOLLEY + 1);
+
+	if (Ar.IsLoading())
+	{
+		AimRotation = FRotator(FRotator::DecompressAxisFromShort(Pitch), FRotator::DecompressAxisFromShort(Yaw), 0);
+		SpreadAmount = (float)Spread / MAX_uint16;
+		Pellets.SetNum(PelletCount);
+	}
+
+	for (FMulticastPelletData& Pellet : Pellets)
+	{
+		uint8 HitBit = Pellet.HitTarget ? 1 : 0;
+		Ar.SerializeBits(&HitBit, 1);
+		Pellet.HitTarget = HitBit != 0;
+
+		//Misses cost a single bit, their tracer end comes from the spread stream
+		if (Pellet.HitTarget)
+		{
+			bOutSuccess &= SerializePackedVector<1, 20>(Pellet.TraceEndPoint, Ar);
+			bOutSuccess &= SerializeFixedVector<1, 16>(Pellet.ImpactNormal, Ar);
+
+			uint32 Surface = Pellet.SurfaceType;
+			Ar.SerializeInt(Surface, SurfaceType_Max);
+			Pellet.SurfaceType = (EPhysicalSurface)Surface;
+		}
+	}
+
+	return true;
+}
+
 ASWeapon::ASWeapon()
 {
 
@@ -33,90 +146,332 @@ ASWeapon::ASWeapon()
 
 	SetReplicates(true);
 	MeshComp->SetIsReplicated(true);
+	MeshComp->BodyInstance.bGenerateWakeEvents = true;
 
-	NetUpdateFrequency = 66;
-	MinNetUpdateFrequency = 33;
+	DroppedNetUpdateFrequency = 66;
+	EquippedNetUpdateFrequency = 10;
+	NetUpdateFrequency = DroppedNetUpdateFrequency;
+	MinNetUpdateFrequency = DroppedNetUpdateFrequency / 2;
+	NetState = ESWeaponNetState::None;
 	DespawnTime = 15;
 	SpeedEqualToMaxSpread = 450;
 
-	//Load from Data Table
-
 	WeaponsDataName = FName(TEXT("Rifle"));
+	WeaponIndex = INDEX_NONE;
+	bSpreadSeedArmed = false;
+}
 
+void ASWeapon::BeginPlay()
+{
+	Super::BeginPlay();
 
-	static ConstructorHelpers::FObjectFinder<UDataTable> WeaponsDataTableObject(TEXT("DataTable'/Game/Core/DT_Weapons.DT_Weapons'"));
-	if (WeaponsDataTableObject.Succeeded())
+	WeaponIndex = FSWeaponRegistry::Get().FindIndex(WeaponsDataName);
+
+	//To prevent crashing the engine from DataTable mistakes delete the current actor
+	if (WeaponIndex == INDEX_NONE)
 	{
-		WeaponsDataTable = WeaponsDataTableObject.Object;
+		if (GEngine)
+		{
+			GEngine->AddOnScreenDebugMessage(-1, 5, FColor::Red, "DataTable entry fatal error! Destroying weapon to prevent crash");
+			Destroy();
+		}
+		
+		return;
 	}
 
-	static ConstructorHelpers::FObjectFinder<UDataTable> WeaponsSoundDataTableObject(TEXT("DataTable'/Game/Core/DT_WeaponsSounds.DT_WeaponsSounds'"));
-	if (WeaponsSoundDataTableObject.Succeeded())
+	TimeBetweenShots = GetStats().TimeBetweenShots;
+
+	ResolveSocket(MuzzleSocket, MuzzleSocketName);
+	ResolveSocket(CenterSocket, CenterSocketName);
+
+	if (Role >= ROLE_Authority)
 	{
-		WeaponsSoundDataTable = WeaponsSoundDataTableObject.Object;
+		CurrentBulletCount = GetStats().BulletsPerMagazine;
+		CurrentMagazineCount = GetStats().DefaultMagazineCount;
+
+		MeshComp->OnComponentSleep.AddDynamic(this, &ASWeapon::OnMeshSleep);
+		MeshComp->OnComponentWake.AddDynamic(this, &ASWeapon::OnMeshWake);
+
+		//Weapons placed in the level are pickups right away
+		if (!GetOwner() && !MeshComp->IsSimulatingPhysics())
+		{
+			AddToPickupGrid();
+			SetNetState(ESWeaponNetState::Idle);
+		}
 	}
+}
 
+void ASWeapon::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	RemoveFromPickupGrid();
+	StopFire();
+	SetNetState(ESWeaponNetState::None);
+
+	Super::EndPlay(EndPlayReason);
 }
 
-void ASWeapon::BeginPlay()
+void ASWeapon::ResolveSocket(FSCachedSocket& Cache, FName SocketName)
 {
-	Super::BeginPlay();
+	Cache.Name = SocketName;
+	Cache.BoneIndex = INDEX_NONE;
+	Cache.RelativeTransform = FTransform::Identity;
+	Cache.Frame = MAX_uint64;
 
-	FWeaponData* WeaponsDataPrt = WeaponsDataTable->FindRow<FWeaponData>(WeaponsDataName, "Weapon", true);
+	const USkeletalMeshSocket* Socket = MeshComp->SkeletalMesh ? MeshComp->SkeletalMesh->FindSocket(SocketName) : nullptr;
 
-	WeaponsSoundData = WeaponsSoundDataTable->FindRow<FWeaponSoundData>(WeaponsDataName, "Weapon", true);
+	if (Socket)
+	{
+		Cache.BoneIndex = MeshComp->GetBoneIndex(Socket->BoneName);
+		Cache.RelativeTransform = FTransform(Socket->RelativeRotation, Socket->RelativeLocation, Socket->RelativeScale);
+	}
+	else
+	{
+		Cache.BoneIndex = MeshComp->GetBoneIndex(SocketName);
+	}
+}
 
-	//To prevent crashing the engine from DataTable mistakes delete the current actor nullptr
-	if (!WeaponsDataPrt || !WeaponsSoundData)
+const FTransform& ASWeapon::GetCachedSocketTransform(FSCachedSocket& Cache)
+{
+	if (Cache.Frame != GFrameCounter)
 	{
-		if (GEngine)
+		Cache.Frame = GFrameCounter;
+
+		//Same fallback as GetSocketTransform, unknown names resolve to the component
+		if (Cache.BoneIndex != INDEX_NONE)
 		{
-			GEngine->AddOnScreenDebugMessage(-1, 5, FColor::Red, "DataTable entry fatal error! Destroying weapon to prevent crash");
-			Destroy();
+			Cache.WorldTransform = Cache.RelativeTransform * MeshComp->GetBoneTransform(Cache.BoneIndex);
 		}
-		
+		else
+		{
+			Cache.WorldTransform = MeshComp->GetComponentTransform();
+		}
+	}
+
+	return Cache.WorldTransform;
+}
+
+void ASWeapon::InvalidateSocketCache()
+{
+	MuzzleSocket.Frame = MAX_uint64;
+	CenterSocket.Frame = MAX_uint64;
+}
+
+FVector ASWeapon::GetMuzzleLocation()
+{
+	return GetCachedSocketTransform(MuzzleSocket).GetLocation();
+}
+
+FVector ASWeapon::GetCenterLocation()
+{
+	return GetCachedSocketTransform(CenterSocket).GetLocation();
+}
+
+void ASWeapon::BenchmarkSocketCache(int32 Iterations)
+{
+	//A volley asks for the center once and the muzzle twice, blocked check and effects
+	FVector Sink = FVector::ZeroVector;
+
+	double StartTime = FPlatformTime::Seconds();
+
+	for (int32 i = 0; i < Iterations; i++)
+	{
+		Sink += MeshComp->GetSocketLocation(CenterSocketName);
+		Sink += MeshComp->GetSocketLocation(MuzzleSocketName);
+		Sink += MeshComp->GetSocketLocation(MuzzleSocketName);
+	}
+
+	double UncachedTime = FPlatformTime::Seconds() - StartTime;
+
+	StartTime = FPlatformTime::Seconds();
+
+	for (int32 i = 0; i < Iterations; i++)
+	{
+		//Every volley as if it was the first one of a new frame
+		InvalidateSocketCache();
+
+		Sink += GetCenterLocation();
+		Sink += GetMuzzleLocation();
+		Sink += GetMuzzleLocation();
+	}
+
+	double CachedTime = FPlatformTime::Seconds() - StartTime;
+
+	UE_LOG(LogTemp, Log, TEXT("BenchmarkWeaponSockets %s: %d volleys, by name %.3f ms, cached %.3f ms (%s)"), *GetName(), Iterations, UncachedTime * 1000.0, CachedTime * 1000.0, *Sink.ToString());
+}
+
+void ASWeapon::OnMeshSleep(UPrimitiveComponent * SleepingComponent, FName BoneName)
+{
+	if (!GetOwner())
+	{
+		AddToPickupGrid();
+		SetNetState(ESWeaponNetState::Idle);
+	}
+}
+
+void ASWeapon::OnMeshWake(UPrimitiveComponent * WakingComponent, FName BoneName)
+{
+	if (!GetOwner())
+	{
+		RemoveFromPickupGrid();
+		SetNetState(ESWeaponNetState::Dropped);
+	}
+}
+
+void ASWeapon::SetNetState(ESWeaponNetState NewState)
+{
+	if (Role < ROLE_Authority || NewState == NetState)
+	{
 		return;
 	}
 
-	WeaponsData = *WeaponsDataPrt;
+	int32 SavedEquipped = FMath::RoundToInt(DroppedNetUpdateFrequency - EquippedNetUpdateFrequency);
+	int32 SavedIdle = FMath::RoundToInt(DroppedNetUpdateFrequency);
+
+	switch (NetState)
+	{
+	case ESWeaponNetState::Equipped:
+		DEC_DWORD_STAT(STAT_WeaponsEquipped);
+		DEC_DWORD_STAT_BY(STAT_WeaponUpdatesSavedEquipped, SavedEquipped);
+		break;
+	case ESWeaponNetState::Dropped:
+		DEC_DWORD_STAT(STAT_WeaponsDropped);
+		break;
+	case ESWeaponNetState::Idle:
+		DEC_DWORD_STAT(STAT_WeaponsIdle);
+		DEC_DWORD_STAT_BY(STAT_WeaponUpdatesSavedIdle, SavedIdle);
+		break;
+	default:
+		break;
+	}
+
+	NetState = NewState;
 
-	TimeBetweenShots = 60 / WeaponsData.RateOfFire;
+	switch (NetState)
+	{
+	case ESWeaponNetState::Equipped:
+		INC_DWORD_STAT(STAT_WeaponsEquipped);
+		INC_DWORD_STAT_BY(STAT_WeaponUpdatesSavedEquipped, SavedEquipped);
+		NetUpdateFrequency = EquippedNetUpdateFrequency;
+		MinNetUpdateFrequency = EquippedNetUpdateFrequency / 2;
+		SetNetDormancy(DORM_Awake);
+		break;
+	case ESWeaponNetState::Dropped:
+		INC_DWORD_STAT(STAT_WeaponsDropped);
+		NetUpdateFrequency = DroppedNetUpdateFrequency;
+		MinNetUpdateFrequency = DroppedNetUpdateFrequency / 2;
+		SetNetDormancy(DORM_Awake);
+		break;
+	case ESWeaponNetState::Idle:
+		INC_DWORD_STAT(STAT_WeaponsIdle);
+		//Everything about it already replicated while it was falling
+		SetNetDormancy(DORM_DormantAll);
+		break;
+	default:
+		//The pool owns dormancy of released weapons
+		break;
+	}
+}
 
-	if (Role >= ROLE_Authority)
+void ASWeapon::AddToPickupGrid()
+{
+	ASGameMode* GM = GetWorld()->GetAuthGameMode<ASGameMode>();
+
+	if (GM)
+	{
+		GM->GetPickupGrid().Add(this, GetActorLocation());
+	}
+}
+
+void ASWeapon::RemoveFromPickupGrid()
+{
+	UWorld* World = GetWorld();
+	ASGameMode* GM = World ? World->GetAuthGameMode<ASGameMode>() : nullptr;
+
+	if (GM)
 	{
-		CurrentBulletCount = WeaponsData.BulletsPerMagazine;
-		CurrentMagazineCount = WeaponsData.DefaultMagazineCount;
+		GM->GetPickupGrid().Remove(this);
 	}
 }
 
 void ASWeapon::MulticastReloadSound_Implementation()
 {
-	if (WeaponsSoundData->Reload)
+	if (GetSounds().Reload)
 	{
-		UGameplayStatics::PlaySoundAtLocation(GetWorld(), WeaponsSoundData->Reload, MeshComp->GetSocketLocation(CenterSocketName), 1, 1, 0, SoundAttenuation);
+		USAudioDispatchComponent::PlaySoundAtLocation(this, GetSounds().Reload, GetCenterLocation(), ESSoundCategory::Weapon, SoundAttenuation);
 	}
 }
 
 void ASWeapon::StartFire()
 {
-	float FirstDelay = FMath::Max(LastFireTimeStamp + TimeBetweenShots - GetWorld()->TimeSeconds, 0.0f);
+	ASGameState* GS = GetWorld()->GetGameState<ASGameState>();
 
-	FTimerDelegate RespawnDelegate = FTimerDelegate::CreateUObject(this, &ASWeapon::Fire, 1);
+	if (GS)
+	{
+		float FirstDelay = FMath::Max(LastFireTimeStamp + TimeBetweenShots - GetWorld()->TimeSeconds, 0.0f);
 
-	GetWorldTimerManager().SetTimer(TimerHandle_TimeBetweenShots, RespawnDelegate, TimeBetweenShots, true, FirstDelay);
+		GS->GetFireScheduler()->StartFiring(this, FirstDelay, TimeBetweenShots);
+	}
 }
 
 void ASWeapon::StopFire()
 {
-	GetWorldTimerManager().ClearTimer(TimerHandle_TimeBetweenShots);
+	ASGameState* GS = GetWorld()->GetGameState<ASGameState>();
+
+	if (GS)
+	{
+		GS->GetFireScheduler()->StopFiring(this);
+	}
+}
+
+void ASWeapon::FireScheduledShot()
+{
+	Fire(GetPelletsPerShot());
+}
+
+int32 ASWeapon::GetPelletsPerShot() const
+{
+	return 1;
 }
 
 void ASWeapon::GetEquippedBy(AActor * NewOwner)
 {
 	SetOwner(NewOwner);
+	RemoveFromPickupGrid();
+	InvalidateSocketCache();
+
+	//New owner, new spread stream. The owners client restarts its count when the seed arrives
+	SpreadSeed = FMath::Rand();
+	ShotCounter = 0;
+
 	MeshComp->SetSimulatePhysics(false);
 	MeshComp->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-	SetLifeSpan(0);
+	GetWorldTimerManager().ClearTimer(TimerHandle_Despawn);
+
+	SetNetState(ESWeaponNetState::Equipped);
+
+	//The new owner predicts only once the seed arrived, don't leave that to the equipped update rate
+	ForceNetUpdate();
+}
+
+void ASWeapon::OnRep_Owner()
+{
+	Super::OnRep_Owner();
+
+	//Owner replicates before SpreadSeed, whatever seed is known now belongs to the previous owner
+	bSpreadSeedArmed = false;
+}
+
+void ASWeapon::OnRep_SpreadSeed()
+{
+	//Arrives in the same update as the new owner, before it this client could not reach ServerFire, so the server is at zero too
+	ShotCounter = 0;
+
+	for (FPredictedVolley& Volley : PredictedVolleys)
+	{
+		Volley = FPredictedVolley();
+	}
+
+	bSpreadSeedArmed = true;
 }
 
 void ASWeapon::Unequip()
@@ -128,129 +483,389 @@ void ASWeapon::Unequip()
 
 		FDetachmentTransformRules DetchmentRules = FDetachmentTransformRules::KeepWorldTransform;
 		DetachFromActor(DetchmentRules);
+		InvalidateSocketCache();
 
 		MeshComp->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
 
 		MeshComp->SetSimulatePhysics(true);
 		MeshComp->SetPhysicsLinearVelocity(OwnerVelocity);
 		FVector Direction = GetActorRightVector() + FVector::UpVector;
-		MeshComp->AddImpulse(Direction * WeaponsData.ThrowForce);
+		MeshComp->AddImpulse(Direction * GetStats().ThrowForce);
+
+		GetWorldTimerManager().SetTimer(TimerHandle_Despawn, this, &ASWeapon::Despawn, DespawnTime, false);
+
+		SetNetState(ESWeaponNetState::Dropped);
+	}
+}
+
+void ASWeapon::Despawn()
+{
+	ASGameMode* GM = GetWorld()->GetAuthGameMode<ASGameMode>();
 
-		SetLifeSpan(DespawnTime);
+	if (GM)
+	{
+		GM->GetActorPool()->Release(this);
+	}
+	else
+	{
+		Destroy();
 	}
 }
 
+void ASWeapon::OnAcquiredFromPool()
+{
+	CurrentBulletCount = GetStats().BulletsPerMagazine;
+	CurrentMagazineCount = GetStats().DefaultMagazineCount;
+	LastFireTimeStamp = 0;
+
+	MeshComp->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+}
+
+void ASWeapon::OnReleasedToPool()
+{
+	StopFire();
+	GetWorldTimerManager().ClearTimer(TimerHandle_Despawn);
+
+	RemoveFromPickupGrid();
+	SetNetState(ESWeaponNetState::None);
+
+	MeshComp->SetSimulatePhysics(false);
+	MeshComp->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+}
+
 void ASWeapon::Fire(int PelletsAmount)
 {
 	LastFireTimeStamp = GetWorld()->TimeSeconds;
 
+	ShotCounter += 1;
+
 	if (Role < ROLE_Authority)
 	{
-		ServerFire(PelletsAmount);
+		AGameStateBase* GS = GetWorld()->GetGameState();
+		float ClientTime = GS ? GS->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+
+		PredictVolley(PelletsAmount, ShotCounter);
+		ServerFire(PelletsAmount, ShotCounter, ClientTime);
+		FSHotPathStats::AddCount(ESHotPathCounter::WeaponRPCs);
 		return;
 	}
 
+	FireVolley(PelletsAmount, ShotCounter, GetWorld()->GetTimeSeconds());
+}
+
+void ASWeapon::FireVolley(int PelletsAmount, int32 ShotIndex, float RewindTime)
+{
+	COOP_HOT_PATH_SCOPE(WeaponFire);
+
 	AActor* MyOwner = GetOwner();
 
 	if (MyOwner)
 	{
-		FMulticastShotData MulticastData = FMulticastShotData();
-
 		FCollisionQueryParams QueryParams;
 		QueryParams.AddIgnoredActor(MyOwner);
 		QueryParams.AddIgnoredActor(this);
 		QueryParams.bTraceComplex = true;
 		QueryParams.bReturnPhysicalMaterial = true;
 
+		FMulticastShotData MulticastData = FMulticastShotData();
+
 		if (CurrentBulletCount <= 0)
 		{
 			MulticastData.NoShot = true;
 			MultiCastFire(MulticastData);
+			FSHotPathStats::AddCount(ESHotPathCounter::WeaponRPCs);
 			return;
 		}
 
-		FHitResult Hit;
+		FVector WeaponMuzzle;
+
+		if (IsMuzzleBlocked(QueryParams, WeaponMuzzle))
+		{
+			return;
+		}
 
-		//Check if weapon is inside a wall, don't allow shooting if thats the case
-		FVector WeaponCenter = MeshComp->GetSocketLocation(CenterSocketName);
-		FVector WeaponMuzzle = MeshComp->GetSocketLocation(MuzzleSocketName);
+		ComputeVolleyAim(MyOwner, ShotIndex, MulticastData);
+
+		FSCombatEventRecorder::Get().Record(ESCombatEventType::Shot, GetWorld()->GetTimeSeconds(), FSCombatEventRecorder::GetActorId(MyOwner), -1, MulticastData.TraceStart, 0, (uint16)PelletsAmount);
+
+		ExpandPelletDirections(MulticastData, PelletsAmount, PelletResults);
 
-		if (GetWorld()->LineTraceSingleByChannel(Hit, WeaponCenter, WeaponMuzzle, COLLISION_WEAPON, QueryParams))
 		{
-			if (DebugWeaponDrawing > 0)
+			TArray<FVector, TInlineAllocator<16>> RayEnds;
+
+			for (const FPelletTraceResult& Pellet : PelletResults)
 			{
-				DrawDebugLine(GetWorld(), WeaponCenter, WeaponMuzzle, FColor::Red, false, 1.0f, 0, 1.0f);
+				RayEnds.Add(Pellet.TraceEnd);
 			}
-			return;
+
+			//Only hitboxes the pellets can reach are moved back to what the shooter saw
+			FSScopedLagCompensation LagCompensation(GetWorld(), RewindTime, MulticastData.TraceStart, RayEnds, MyOwner);
+
+			TracePellets(MulticastData.TraceStart, WeaponMuzzle, QueryParams, PelletResults);
 		}
 
-		for (size_t i = 0; i < PelletsAmount; i++)
+		ApplyPelletDamage(MyOwner, PelletResults);
+
+		FillVolleyPellets(PelletResults, MulticastData);
+
+		if (DebugWeaponDrawing > 0)
+		{
+			for (const FPelletTraceResult& Pellet : PelletResults)
+			{
+				DrawDebugLine(GetWorld(), WeaponMuzzle, Pellet.TraceEnd, FColor::White, false, 1.0f, 0, 1.0f);
+
+				if (!Pellet.bHit)
+				{
+					DrawDebugSphere(GetWorld(), Pellet.TraceEnd, 20, 8, FColor::Yellow, false, 1.0f, 0, 1.0f);
+				}
+			}
+		}
+
+		MultiCastFire(MulticastData);
+		FSHotPathStats::AddCount(ESHotPathCounter::WeaponRPCs);
+
+		if (WeaponNetStats > 0)
 		{
-			FVector TraceStart;
-			FRotator EyeRotation;
-			MyOwner->GetActorEyesViewPoint(TraceStart, EyeRotation);
+			RecordShotNetStats(MulticastData);
+		}
 
-			FVector ShotDirection = EyeRotation.Vector();
+		CurrentBulletCount -= 1;
 
-			float SpreadMultiplyer = FMath::GetMappedRangeValueClamped(FVector2D(0, SpeedEqualToMaxSpread), FVector2D(0, 1), GetOwner()->GetVelocity().Size());
+		//Sends the queued volley multicast and the new ammo now instead of at the low equipped rate
+		ForceNetUpdate();
+	}
+}
 
-			float SpreadAmount = WeaponsData.BaseSpreadInDegrees/360.0f + ((WeaponsData.MaxSpreadInDegrees - WeaponsData.BaseSpreadInDegrees) / 360.0f) * SpreadMultiplyer;
+void ASWeapon::PredictVolley(int PelletsAmount, int32 ShotIndex)
+{
+	APawn* MyOwner = Cast<APawn>(GetOwner());
 
-			ShotDirection = FMath::VRandCone(ShotDirection, SpreadAmount);
+	//Only the owning client can predict, everyone else waits for the multicast
+	if (!MyOwner || !MyOwner->IsLocallyControlled() || !bSpreadSeedArmed || CurrentBulletCount <= 0)
+	{
+		return;
+	}
 
-			FVector TraceEnd = TraceStart + (ShotDirection * WeaponsData.HitMaxDistance);
+	FCollisionQueryParams QueryParams;
+	QueryParams.AddIgnoredActor(MyOwner);
+	QueryParams.AddIgnoredActor(this);
+	QueryParams.bTraceComplex = true;
+	QueryParams.bReturnPhysicalMaterial = true;
 
-			FVector TracerEndPoint = TraceEnd;
+	FVector WeaponMuzzle;
 
-			//Get where the crosshair is looking so that you can hit close objects
-			if (GetWorld()->LineTraceSingleByChannel(Hit, TraceStart, TraceEnd, COLLISION_WEAPON, QueryParams))
-			{
-				TraceEnd = WeaponMuzzle + (Hit.ImpactPoint - WeaponMuzzle) * WeaponsData.HitMaxDistance;
-			}
+	if (IsMuzzleBlocked(QueryParams, WeaponMuzzle))
+	{
+		return;
+	}
 
-			//Get from the Weapon Muzzle to the new TraceEnd
-			if (GetWorld()->LineTraceSingleByChannel(Hit, WeaponMuzzle, TraceEnd, COLLISION_WEAPON, QueryParams))
-			{
-				AActor* HitActor = Hit.GetActor();
+	FMulticastShotData PredictedData = FMulticastShotData();
 
-				EPhysicalSurface SurfaceType = UPhysicalMaterial::DetermineSurfaceType(Hit.PhysMaterial.Get());
-				float ActualDamage = WeaponsData.BaseDamage;
+	ComputeVolleyAim(MyOwner, ShotIndex, PredictedData);
 
-				if (SurfaceType == SURFACE_FLESHVULNERABLE)
-				{
-					ActualDamage *= WeaponsData.HeadshotMultiplyer;
-				}
-				else if (SurfaceType == SURFACE_FLESHRESISTANT) 
-				{
-					ActualDamage *= WeaponsData.WeakshotMultiplyer;
-				}
+	ExpandPelletDirections(PredictedData, PelletsAmount, PelletResults);
 
-				UGameplayStatics::ApplyPointDamage(HitActor, ActualDamage, ShotDirection, Hit, MyOwner->GetInstigatorController(), this, WeaponsData.DamageType);
+	TracePellets(PredictedData.TraceStart, WeaponMuzzle, QueryParams, PelletResults);
 
-				TracerEndPoint = Hit.ImpactPoint;
+	FillVolleyPellets(PelletResults, PredictedData);
 
-				MulticastData.NoShot = false;
-				MulticastData.HitTarget = true;
-				MulticastData.ImpactPoint = Hit.ImpactPoint;
-				MulticastData.ImpactNormal = Hit.ImpactNormal;
-				MulticastData.SurfaceType = SurfaceType;
-			}
+	FPredictedVolley& Volley = PredictedVolleys[ShotIndex % PREDICTED_VOLLEY_HISTORY];
+	Volley.ShotIndex = ShotIndex;
+	Volley.HitMask = 0;
 
-			MulticastData.TraceEndPoint = TracerEndPoint;
-			MultiCastFire(MulticastData);
+	PlayFireEffects(PredictedData);
 
-			if (DebugWeaponDrawing > 0)
-			{
-				DrawDebugLine(GetWorld(), WeaponMuzzle, TraceEnd, FColor::White, false, 1.0f, 0, 1.0f);
+	for (int32 i = 0; i < PredictedData.Pellets.Num(); i++)
+	{
+		const FMulticastPelletData& Pellet = PredictedData.Pellets[i];
 
-				if (!MulticastData.HitTarget)
-				{
-					DrawDebugSphere(GetWorld(), TraceEnd, 20, 8, FColor::Yellow, false, 1.0f, 0, 1.0f);
-				}
-			}
+		if (Pellet.HitTarget)
+		{
+			Volley.HitMask |= (uint64)1 << i;
+			PlayImpactEffects(Pellet.TraceEndPoint, Pellet.ImpactNormal, Pellet.SurfaceType);
 		}
+	}
+}
 
-		CurrentBulletCount -= 1;
+const FPredictedVolley* ASWeapon::FindPredictedVolley(int32 ShotIndex) const
+{
+	if (ShotIndex < 0)
+	{
+		return nullptr;
+	}
+
+	//Volleys that were never predicted, or fell out of the history, get played in full
+	const FPredictedVolley& Volley = PredictedVolleys[ShotIndex % PREDICTED_VOLLEY_HISTORY];
+	return Volley.ShotIndex == ShotIndex ? &Volley : nullptr;
+}
+
+bool ASWeapon::IsMuzzleBlocked(const FCollisionQueryParams& QueryParams, FVector& OutWeaponMuzzle)
+{
+	FHitResult Hit;
+
+	//Check if weapon is inside a wall, don't allow shooting if thats the case
+	FVector WeaponCenter = GetCenterLocation();
+	OutWeaponMuzzle = GetMuzzleLocation();
+
+	FSHotPathStats::AddCount(ESHotPathCounter::Traces);
+
+	if (GetWorld()->LineTraceSingleByChannel(Hit, WeaponCenter, OutWeaponMuzzle, COLLISION_WEAPON, QueryParams))
+	{
+		if (DebugWeaponDrawing > 0)
+		{
+			DrawDebugLine(GetWorld(), WeaponCenter, OutWeaponMuzzle, FColor::Red, false, 1.0f, 0, 1.0f);
+		}
+		return true;
+	}
+
+	return false;
+}
+
+void ASWeapon::ComputeVolleyAim(AActor* MyOwner, int32 ShotIndex, FMulticastShotData& OutShotData)
+{
+	//View point and spread are the same for every pellet of a volley
+	MyOwner->GetActorEyesViewPoint(OutShotData.TraceStart, OutShotData.AimRotation);
+
+	float SpreadMultiplyer = FMath::GetMappedRangeValueClamped(FVector2D(0, SpeedEqualToMaxSpread), FVector2D(0, 1), MyOwner->GetVelocity().Size());
+
+	const FSWeaponHotStats& Stats = GetStats();
+	OutShotData.SpreadAmount = Stats.BaseSpreadInDegrees / 360.0f + ((Stats.MaxSpreadInDegrees - Stats.BaseSpreadInDegrees) / 360.0f) * SpreadMultiplyer;
+	OutShotData.ShotIndex = ShotIndex;
+	OutShotData.NoShot = false;
+
+	OutShotData.QuantizeAim();
+}
+
+void ASWeapon::ExpandPelletDirections(const FMulticastShotData& ShotData, int PelletsAmount, TArray<FPelletTraceResult>& OutResults)
+{
+	PelletsAmount = FMath::Clamp(PelletsAmount, 1, MAX_PELLETS_PER_VOLLEY);
+
+	OutResults.Reset(PelletsAmount);
+	OutResults.AddDefaulted(PelletsAmount);
+
+	//Same seed and shot index give the same cone on every machine
+	FRandomStream SpreadStream(HashCombine(SpreadSeed, ShotData.ShotIndex));
+	const FVector AimDirection = ShotData.AimRotation.Vector();
+
+	for (FPelletTraceResult& Pellet : OutResults)
+	{
+		Pellet.Direction = SpreadStream.VRandCone(AimDirection, ShotData.SpreadAmount);
+		Pellet.TraceEnd = ShotData.TraceStart + (Pellet.Direction * GetStats().HitMaxDistance);
+		Pellet.TracerEnd = Pellet.TraceEnd;
+	}
+}
+
+void ASWeapon::TracePellets(const FVector& TraceStart, const FVector& WeaponMuzzle, const FCollisionQueryParams& QueryParams, TArray<FPelletTraceResult>& InOutResults)
+{
+	COOP_HOT_PATH_SCOPE(PelletTraces);
+	FSHotPathStats::AddCount(ESHotPathCounter::Traces, InOutResults.Num() * 2);
+
+	//Directions were generated up front on the game thread, the trace jobs only read them
+	UWorld* World = GetWorld();
+	const float HitMaxDistance = GetStats().HitMaxDistance;
+
+	ParallelFor(InOutResults.Num(), [&](int32 Index)
+	{
+		FPelletTraceResult& Pellet = InOutResults[Index];
+		FHitResult CrosshairHit;
+
+		//Get where the crosshair is looking so that you can hit close objects
+		if (World->LineTraceSingleByChannel(CrosshairHit, TraceStart, Pellet.TraceEnd, COLLISION_WEAPON, QueryParams))
+		{
+			Pellet.TraceEnd = WeaponMuzzle + (CrosshairHit.ImpactPoint - WeaponMuzzle) * HitMaxDistance;
+		}
+
+		//Get from the Weapon Muzzle to the new TraceEnd
+		Pellet.bHit = World->LineTraceSingleByChannel(Pellet.Hit, WeaponMuzzle, Pellet.TraceEnd, COLLISION_WEAPON, QueryParams);
+	}, InOutResults.Num() < ParallelPelletThreshold);
+
+	for (FPelletTraceResult& Pellet : InOutResults)
+	{
+		if (Pellet.bHit)
+		{
+			Pellet.SurfaceType = UPhysicalMaterial::DetermineSurfaceType(Pellet.Hit.PhysMaterial.Get());
+		}
+	}
+}
+
+void ASWeapon::FillVolleyPellets(const TArray<FPelletTraceResult>& Results, FMulticastShotData& OutShotData)
+{
+	OutShotData.Pellets.Reset();
+
+	for (const FPelletTraceResult& Pellet : Results)
+	{
+		FMulticastPelletData& PelletData = OutShotData.Pellets.AddDefaulted_GetRef();
+		PelletData.HitTarget = Pellet.bHit;
+		PelletData.TraceEndPoint = Pellet.bHit ? Pellet.Hit.ImpactPoint : Pellet.TracerEnd;
+
+		if (Pellet.bHit)
+		{
+			PelletData.ImpactNormal = Pellet.Hit.ImpactNormal;
+			PelletData.SurfaceType = Pellet.SurfaceType;
+		}
+	}
+}
+
+void ASWeapon::ApplyPelletDamage(AActor* MyOwner, const TArray<FPelletTraceResult>& Results)
+{
+	struct FVictimDamage
+	{
+		AActor* Victim;
+		float Damage;
+		float StrongestPelletDamage;
+		int32 StrongestPellet;
+	};
+
+	//A volley rarely hits more than a handful of actors, a linear search beats a map here
+	TArray<FVictimDamage, TInlineAllocator<8>> Victims;
+
+	const FSWeaponHotStats& Stats = GetStats();
+
+	for (int32 i = 0; i < Results.Num(); i++)
+	{
+		const FPelletTraceResult& Pellet = Results[i];
+
+		if (!Pellet.bHit)
+		{
+			continue;
+		}
+
+		float ActualDamage = Stats.BaseDamage;
+
+		if (Pellet.SurfaceType == SURFACE_FLESHVULNERABLE)
+		{
+			ActualDamage *= Stats.HeadshotMultiplyer;
+		}
+		else if (Pellet.SurfaceType == SURFACE_FLESHRESISTANT)
+		{
+			ActualDamage *= Stats.WeakshotMultiplyer;
+		}
+
+		AActor* HitActor = Pellet.Hit.GetActor();
+		FVictimDamage* Entry = Victims.FindByPredicate([HitActor](const FVictimDamage& Other) { return Other.Victim == HitActor; });
+
+		if (!Entry)
+		{
+			Entry = &Victims[Victims.Add({ HitActor, 0.0f, 0.0f, i })];
+		}
+
+		Entry->Damage += ActualDamage;
+
+		if (ActualDamage > Entry->StrongestPelletDamage)
+		{
+			Entry->StrongestPelletDamage = ActualDamage;
+			Entry->StrongestPellet = i;
+		}
+	}
+
+	//One damage event per victim, reported with the hit of the pellet that did the most damage
+	for (const FVictimDamage& Entry : Victims)
+	{
+		const FPelletTraceResult& Pellet = Results[Entry.StrongestPellet];
+
+		FSCombatEventRecorder::Get().Record(ESCombatEventType::Hit, GetWorld()->GetTimeSeconds(), FSCombatEventRecorder::GetActorId(MyOwner), FSCombatEventRecorder::GetActorId(Entry.Victim), Pellet.Hit.ImpactPoint, Entry.Damage, (uint16)Pellet.SurfaceType);
+
+		UGameplayStatics::ApplyPointDamage(Entry.Victim, Entry.Damage, Pellet.Direction, Pellet.Hit, MyOwner->GetInstigatorController(), this, Stats.DamageType);
 	}
 }
 
@@ -259,6 +874,7 @@ void ASWeapon::Reload()
 	if (Role < ROLE_Authority)
 	{
 		ServerReload();
+		FSHotPathStats::AddCount(ESHotPathCounter::WeaponRPCs);
 		return;
 	}
 
@@ -267,7 +883,7 @@ void ASWeapon::Reload()
 		return;
 	}
 
-	int AmmoDiff = WeaponsData.BulletsPerMagazine - CurrentBulletCount;
+	int AmmoDiff = GetStats().BulletsPerMagazine - CurrentBulletCount;
 
 	if (CurrentMagazineCount < AmmoDiff) 
 	{
@@ -287,13 +903,15 @@ void ASWeapon::Reload()
 
 	CurrentBulletCount += AmmoDiff;
 
-	MulticastReloadSound();	
+	MulticastReloadSound();
+	FSHotPathStats::AddCount(ESHotPathCounter::WeaponRPCs);
+	ForceNetUpdate();
 }
 
 bool ASWeapon::CanReload()
 {
 	//full mag
-	if (CurrentBulletCount >= WeaponsData.BulletsPerMagazine)
+	if (CurrentBulletCount >= GetStats().BulletsPerMagazine)
 	{
 		return false;
 	}
@@ -307,9 +925,27 @@ bool ASWeapon::CanReload()
 	return true;
 }
 
+const FSWeaponHotStats& ASWeapon::GetStats() const
+{
+	return FSWeaponRegistry::Get().GetHotStats(WeaponIndex);
+}
+
+const FWeaponSoundData& ASWeapon::GetSounds() const
+{
+	return FSWeaponRegistry::Get().GetSounds(WeaponIndex);
+}
+
+const FWeaponData& ASWeapon::GetWeaponsData() const
+{
+	static const FWeaponData EmptyData;
+
+	FSWeaponRegistry& Registry = FSWeaponRegistry::Get();
+	return Registry.IsValidIndex(WeaponIndex) ? Registry.GetColdData(WeaponIndex) : EmptyData;
+}
+
 float ASWeapon::GetReloadTime()
 {
-	return WeaponsData.ReloadTime;
+	return GetStats().ReloadTime;
 }
 
 void ASWeapon::ServerReload_Implementation()
@@ -322,37 +958,115 @@ bool ASWeapon::ServerReload_Validate()
 	return true;
 }
 
-void ASWeapon::MultiCastFire_Implementation(FMulticastShotData MulticastData)
+void ASWeapon::MultiCastFire_Implementation(const FMulticastShotData& MulticastData)
 {
 	if (MulticastData.NoShot) 
 	{
-		if (WeaponsSoundData->NoAmmo)
+		if (GetSounds().NoAmmo)
 		{
-			UGameplayStatics::PlaySoundAtLocation(GetWorld(), WeaponsSoundData->NoAmmo, MeshComp->GetSocketLocation(MuzzleSocketName),1, 1, 0, SoundAttenuation);
+			USAudioDispatchComponent::PlaySoundAtLocation(this, GetSounds().NoAmmo, GetMuzzleLocation(), ESSoundCategory::Weapon, SoundAttenuation);
 		}
+		return;
 	}
-	else 
+
+	APawn* MyOwner = Cast<APawn>(GetOwner());
+
+	const FPredictedVolley* Predicted = Role < ROLE_Authority && MyOwner && MyOwner->IsLocallyControlled() ? FindPredictedVolley(MulticastData.ShotIndex) : nullptr;
+
+	//The owning client already played this volley when it fired, only show impacts the prediction missed
+	if (Predicted)
 	{
-		PlayFireEffects(MulticastData.TraceEndPoint);
+		for (int32 i = 0; i < MulticastData.Pellets.Num(); i++)
+		{
+			const FMulticastPelletData& Pellet = MulticastData.Pellets[i];
 
-		if (MulticastData.HitTarget)
+			if (Pellet.HitTarget && !(Predicted->HitMask & ((uint64)1 << i)))
+			{
+				PlayImpactEffects(Pellet.TraceEndPoint, Pellet.ImpactNormal, Pellet.SurfaceType);
+			}
+		}
+		return;
+	}
+
+	FMulticastShotData ShotData = MulticastData;
+
+	//Misses only arrive as a bit, rebuild their tracer end from the spread stream
+	ExpandPelletDirections(ShotData, ShotData.Pellets.Num(), PelletResults);
+
+	for (int32 i = 0; i < ShotData.Pellets.Num() && i < PelletResults.Num(); i++)
+	{
+		if (!ShotData.Pellets[i].HitTarget)
 		{
-			PlayImpactEffects(MulticastData.ImpactPoint, MulticastData.ImpactNormal, MulticastData.SurfaceType);
+			ShotData.Pellets[i].TraceEndPoint = PelletResults[i].TracerEnd;
+		}
+	}
+
+	PlayFireEffects(ShotData);
+
+	for (const FMulticastPelletData& Pellet : ShotData.Pellets)
+	{
+		if (Pellet.HitTarget)
+		{
+			PlayImpactEffects(Pellet.TraceEndPoint, Pellet.ImpactNormal, Pellet.SurfaceType);
 		}
 	}
 }
 
-void ASWeapon::ServerFire_Implementation(int PelletsAmount)
+void ASWeapon::RecordShotNetStats(const FMulticastShotData& MulticastData)
 {
-	Fire(PelletsAmount);
+	bool bSuccess = true;
+	FMulticastShotData Volley = MulticastData;
+
+	FNetBitWriter VolleyWriter(nullptr, 8192);
+	Volley.NetSerialize(VolleyWriter, nullptr, bSuccess);
+
+	//What the old one reliable RPC per pellet layout cost: two quantized points, a normal, the surface byte and two flags. RPC headers are not included
+	FNetBitWriter PerPelletWriter(nullptr, 8192);
+
+	ExpandPelletDirections(Volley, Volley.Pellets.Num(), PelletResults);
+
+	for (int32 i = 0; i < Volley.Pellets.Num(); i++)
+	{
+		FMulticastPelletData Pellet = Volley.Pellets[i];
+		uint8 Flags = Pellet.HitTarget ? 1 : 0;
+		uint8 Surface = Pellet.SurfaceType;
+		FVector TracerEnd = Pellet.HitTarget ? Pellet.TraceEndPoint : PelletResults[i].TracerEnd;
+		FVector ImpactPoint = Pellet.TraceEndPoint;
+
+		PerPelletWriter.SerializeBits(&Flags, 2);
+		SerializePackedVector<1, 20>(TracerEnd, PerPelletWriter);
+		SerializePackedVector<1, 20>(ImpactPoint, PerPelletWriter);
+		SerializeFixedVector<1, 16>(Pellet.ImpactNormal, PerPelletWriter);
+		PerPelletWriter << Surface;
+	}
+
+	SET_DWORD_STAT(STAT_VolleyBytesPerShot, VolleyWriter.GetNumBytes());
+	SET_DWORD_STAT(STAT_PerPelletBytesPerShot, PerPelletWriter.GetNumBytes());
+	INC_DWORD_STAT_BY(STAT_VolleyBytesTotal, VolleyWriter.GetNumBytes());
 }
 
-bool ASWeapon::ServerFire_Validate(int PelletsAmount)
+void ASWeapon::ServerFire_Implementation(int PelletsAmount, int32 ShotIndex, float ClientTime)
 {
-	return true;
+	LastFireTimeStamp = GetWorld()->TimeSeconds;
+
+	//The client knows the seed, if it picked the index it could send the one with the tightest upcoming cone
+	ShotCounter += 1;
+
+	//Its index only has to match for its prediction, a mismatch just plays this volley in full on the owner
+	if (ShotIndex != ShotCounter)
+	{
+		INC_DWORD_STAT(STAT_ShotIndexMismatches);
+	}
+
+	FireVolley(PelletsAmount, ShotCounter, ClientTime);
+}
+
+bool ASWeapon::ServerFire_Validate(int PelletsAmount, int32 ShotIndex, float ClientTime)
+{
+	return PelletsAmount > 0 && PelletsAmount <= MAX_PELLETS_PER_VOLLEY;
 }
 
-void ASWeapon::PlayFireEffects(FVector TracerEndPoint)
+void ASWeapon::PlayFireEffects(const FMulticastShotData& ShotData)
 {
 
 	if (MuzzleEffect)
@@ -360,14 +1074,20 @@ void ASWeapon::PlayFireEffects(FVector TracerEndPoint)
 		UGameplayStatics::SpawnEmitterAttached(MuzzleEffect, MeshComp, MuzzleSocketName);
 	}
 
-	if (TracerEffect)
-	{
-		FVector MuzzleLocation = MeshComp->GetSocketLocation(MuzzleSocketName);
-		UParticleSystemComponent* TracerComp = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), TracerEffect, MuzzleLocation);
+	FVector MuzzleLocation = GetMuzzleLocation();
 
-		if (TracerComp)
+	ASGameState* GS = GetWorld()->GetGameState<ASGameState>();
+
+	if (TracerEffect && GS)
+	{
+		for (const FMulticastPelletData& Pellet : ShotData.Pellets)
 		{
-			TracerComp->SetVectorParameter(TracerTargetName, TracerEndPoint);
+			UParticleSystemComponent* TracerComp = GS->GetEffectPool()->SpawnTracer(TracerEffect, MuzzleLocation);
+
+			if (TracerComp)
+			{
+				TracerComp->SetVectorParameter(TracerTargetName, Pellet.TraceEndPoint);
+			}
 		}
 	}
 
@@ -383,14 +1103,22 @@ void ASWeapon::PlayFireEffects(FVector TracerEndPoint)
 		}
 	}
 
-	if (WeaponsSoundData->Shot)
+	if (GetSounds().Shot)
 	{
-		UGameplayStatics::PlaySoundAtLocation(GetWorld(), WeaponsSoundData->Shot, MeshComp->GetSocketLocation(MuzzleSocketName), 1, 1, 0, SoundAttenuation);
+		USAudioDispatchComponent::PlaySoundAtLocation(this, GetSounds().Shot, MuzzleLocation, ESSoundCategory::Weapon, SoundAttenuation);
 	}
 }
 
 void ASWeapon::PlayImpactEffects(FVector ImpactPoint, FVector ImpactNormal, EPhysicalSurface SurfaceType)
 {
+	ASGameState* GS = GetWorld()->GetGameState<ASGameState>();
+
+	if (!GS)
+	{
+		return;
+	}
+
+	USEffectPoolComponent* EffectPool = GS->GetEffectPool();
 	UParticleSystem* SelectedEffect = nullptr;
 
 	switch (SurfaceType)
@@ -407,16 +1135,12 @@ void ASWeapon::PlayImpactEffects(FVector ImpactPoint, FVector ImpactNormal, EPhy
 
 	default:
 		SelectedEffect = DefaultImpactEffect;
-		UDecalComponent* Decal = UGameplayStatics::SpawnDecalAtLocation(GetWorld(), BulletHitDecal, BulletHitDecalSize, ImpactPoint, (-ImpactNormal).Rotation(), BulletHitDecalLifetime);
-		Decal->SetFadeScreenSize(0.001f);
+		EffectPool->SpawnDecal(BulletHitDecal, BulletHitDecalSize, ImpactPoint, (-ImpactNormal).Rotation(), BulletHitDecalLifetime);
 
 		break;
 	}
 
-	if (SelectedEffect)
-	{
-		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), SelectedEffect, ImpactPoint, ImpactNormal.Rotation());
-	}
+	EffectPool->SpawnImpact(SelectedEffect, ImpactPoint, ImpactNormal.Rotation());
 }
 
 void ASWeapon::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
@@ -425,4 +1149,5 @@ void ASWeapon::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetime
 
 	DOREPLIFETIME(ASWeapon, CurrentBulletCount);
 	DOREPLIFETIME(ASWeapon, CurrentMagazineCount);
+	DOREPLIFETIME_CONDITION_NOTIFY(ASWeapon, SpreadSeed, COND_None, REPNOTIFY_Always);
 }
\ No newline at end of file
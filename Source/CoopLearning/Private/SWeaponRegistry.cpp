@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SWeaponRegistry.h"
+#include "Engine/DataTable.h"
+
+FSWeaponRegistry& FSWeaponRegistry::Get()
+{
+	static FSWeaponRegistry Registry;
+	return Registry;
+}
+
+void FSWeaponRegistry::Build(const UDataTable* WeaponsTable, const UDataTable* SoundsTable)
+{
+	if (!WeaponsTable || !SoundsTable)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("WeaponRegistry: missing weapon DataTables, no weapons registered"));
+		return;
+	}
+
+	for (const TPair<FName, uint8*>& Row : WeaponsTable->GetRowMap())
+	{
+		const FWeaponData* Data = reinterpret_cast<const FWeaponData*>(Row.Value);
+		const FWeaponSoundData* SoundData = SoundsTable->FindRow<FWeaponSoundData>(Row.Key, "WeaponRegistry", true);
+
+		if (!SoundData)
+		{
+			continue;
+		}
+
+		FSWeaponHotStats Stats;
+		Stats.BaseDamage = Data->BaseDamage;
+		Stats.HeadshotMultiplyer = Data->HeadshotMultiplyer;
+		Stats.WeakshotMultiplyer = Data->WeakshotMultiplyer;
+		Stats.RateOfFire = Data->RateOfFire;
+		Stats.TimeBetweenShots = Data->RateOfFire > 0 ? 60 / Data->RateOfFire : 0;
+		Stats.HitMaxDistance = Data->HitMaxDistance;
+		Stats.BaseSpreadInDegrees = Data->BaseSpreadInDegrees;
+		Stats.MaxSpreadInDegrees = Data->MaxSpreadInDegrees;
+		Stats.ThrowForce = Data->ThrowForce;
+		Stats.ReloadTime = Data->ReloadTime;
+		Stats.BulletsPerMagazine = Data->BulletsPerMagazine;
+		Stats.DefaultMagazineCount = Data->DefaultMagazineCount;
+		Stats.DamageType = Data->DamageType;
+
+		const int32* ExistingIndex = IndexByName.Find(Row.Key);
+
+		//Rebuilds only update rows in place, rows gone from the tables are kept for weapons still pointing at them
+		if (ExistingIndex)
+		{
+			HotStats[*ExistingIndex] = Stats;
+			Sounds[*ExistingIndex] = *SoundData;
+			ColdData[*ExistingIndex] = *Data;
+		}
+		else
+		{
+			IndexByName.Add(Row.Key, HotStats.Add(Stats));
+			Sounds.Add(*SoundData);
+			ColdData.Add(*Data);
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("WeaponRegistry: %d weapons registered"), HotStats.Num());
+}
+
+int32 FSWeaponRegistry::FindIndex(FName WeaponName) const
+{
+	const int32* Index = IndexByName.Find(WeaponName);
+	return Index ? *Index : INDEX_NONE;
+}
@@ -28,6 +28,9 @@ ASZipline::ASZipline()
 	CableComp = CreateDefaultSubobject<UCableComponent>(TEXT("CableComp"));
 	CableComp->SetupAttachment(StartComp);
 	CableComp->SetAttachEndToComponent(EndComp);
+
+	//Placed in the level and never changes, clients load it with the map so it stays out of replication entirely
+	SetReplicates(false);
 }
 
 
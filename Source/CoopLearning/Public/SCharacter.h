@@ -10,6 +10,7 @@ class UCameraComponent;
 class USpringArmComponent;
 class ASWeapon;
 class USHealthComponent;
+class USLagCompensationComponent;
 class USphereComponent;
 class ASZipline;
 class ASGranade;
@@ -28,7 +29,51 @@ enum ECharacterState
 	STATE_Normal,
 	STATE_Reloading,
 	STATE_Action,
-	STATE_Zipline
+	STATE_Zipline,
+	STATE_MAX UMETA(Hidden)
+};
+
+//Everything other machines need about a characters state in one replicated property, compared once per net update
+USTRUCT()
+struct FSCharacterRepState
+{
+	GENERATED_BODY()
+
+	//AimProgress in 1/255 steps, the per frame zoom interpolation only dirties it when a step is crossed
+	UPROPERTY()
+	uint8 AimProgress = 0;
+
+	UPROPERTY()
+	TEnumAsByte<ECharacterState> State = STATE_Normal;
+
+	UPROPERTY()
+	bool bDied = false;
+
+	UPROPERTY()
+	bool ZiplineDirectionIsForward = false;
+
+	UPROPERTY()
+	uint8 GranadeCount = 0;
+
+	UPROPERTY()
+	ASZipline* CurrentZipline = nullptr;
+
+	bool operator==(const FSCharacterRepState& Other) const;
+
+	//Everything but the zipline reference, also used to measure the packed size
+	void SerializeBits(FArchive& Ar);
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FSCharacterRepState> : public TStructOpsTypeTraitsBase2<FSCharacterRepState>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true,
+	};
 };
 
 UCLASS()
@@ -106,6 +151,9 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
 	USphereComponent* DetectionComp;
 
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	USLagCompensationComponent* LagCompensationComp;
+
 	UPROPERTY(Replicated, BlueprintReadOnly, Category = "Player")
 	ASWeapon* CurrentWeapon;
 
@@ -128,7 +176,7 @@ protected:
 
 	float DefaultFOV;
 
-	UPROPERTY(Replicated, BlueprintReadOnly, Category = "Player")
+	UPROPERTY(BlueprintReadOnly, Category = "Player")
 	float AimProgress;
 
 	UFUNCTION(Server, Reliable, WithValidation)
@@ -140,15 +188,23 @@ protected:
 	UFUNCTION()
 	void OnHeathChanged(USHealthComponent* SourceHealthComp, float Health, float HealthDelta, const class UDamageType* DamageType, class AController* InstigatedBy, AActor* DamageCauser);
 
-	UPROPERTY(Replicated, BlueprintReadOnly, Category = "Player")
+	UPROPERTY(BlueprintReadOnly, Category = "Player")
 	bool bDied;
 
 	UFUNCTION(NetMulticast, Reliable)
 	void MulticastOnDeathEffects();
 
-	ASWeapon* GetClosestWeapon(FVector sourceLocation, TArray<AActor*> actors);
+	//Closest resting weapon within DetectionComp's radius, looked up in the game modes pickup grid
+	ASWeapon* FindClosestPickupWeapon() const;
 
-	UPROPERTY(Replicated, BlueprintReadOnly, Category = "Player")
+	//Pickup grid version and location ClosestWeapon was last picked for
+	uint32 ClosestWeaponGridVersion;
+
+	FVector ClosestWeaponSourceLocation;
+
+	void UpdateClosestWeapon();
+
+	UPROPERTY(BlueprintReadOnly, Category = "Player")
 	TEnumAsByte<ECharacterState> State;
 
 	TEnumAsByte<ECharacterState> PreviousState;
@@ -157,10 +213,10 @@ protected:
 
 	void SetStateToPrevious();
 
-	UPROPERTY(Replicated, BlueprintReadOnly, Category = "Player")
+	UPROPERTY(BlueprintReadOnly, Category = "Player")
 	ASZipline* CurrentZipline;
 
-	UPROPERTY(Replicated, BlueprintReadOnly, Category = "Player")
+	UPROPERTY(BlueprintReadOnly, Category = "Player")
 	bool ZiplineDirectionIsForward;
 
 	UPROPERTY(EditDefaultsOnly, Category = "Player")
@@ -191,7 +247,7 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "Player")
 	int StartGranadeCount;
 
-	UPROPERTY(Replicated, BlueprintReadOnly, Category = "Player")
+	UPROPERTY(BlueprintReadOnly, Category = "Player")
 	int GranadeCount;
 
 	UFUNCTION(Server, Reliable, WithValidation)
@@ -200,6 +256,22 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "Player")
 	float GranadeThrowForce;
 
+	//Server packs AimProgress, State, bDied, the zipline and GranadeCount in here right before replicating, clients unpack them in OnRep_RepState
+	UPROPERTY(ReplicatedUsing = OnRep_RepState)
+	FSCharacterRepState RepState;
+
+	UFUNCTION()
+	void OnRep_RepState();
+
+	void PackRepState(FSCharacterRepState& OutState) const;
+
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+	//Payload of the packed state against the separate properties it replaced, CharacterNetStats only
+	void RecordRepStateNetStats(const FSCharacterRepState& NewState);
+
+	float LastSentAimProgress;
+
 	virtual void PossessedBy(AController* NewController) override;
 
 	UFUNCTION(Client, Reliable)
@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * On-disk layout of the per match combat event log written by FSCombatEventRecorder. The file is a header followed by
+ * fixed-size records in the order they were flushed, a record count is (file size - header size) / RecordSize.
+ * Shared with Tools/CombatEventReader, so this header must not depend on the engine.
+ */
+namespace SCombatEventFormat
+{
+	//"SCEV" read as little endian
+	const uint32_t Magic = 0x56454353;
+
+	const uint32_t Version = 1;
+
+	enum class ESCombatEventType : uint8_t
+	{
+		//Instigator fired a volley from Location, Aux is the pellet count
+		Shot,
+		//A volley hit Target at Location, Value is the volley damage, Aux the surface of the strongest pellet
+		Hit,
+		//Target lost Value health, Aux is the health left
+		Damage,
+		//Instigator killed Target at Location
+		Death,
+		//Explosion at Location, Value is the damage, Aux the radius in meters
+		Explosion,
+		//Instigator spawned at Location
+		Respawn
+	};
+
+	struct FSCombatEventFileHeader
+	{
+		uint32_t Magic;
+
+		uint32_t Version;
+
+		uint32_t RecordSize;
+
+		uint32_t HeaderSize;
+
+		//Seconds since 1970 when the match started
+		int64_t StartUnixTime;
+
+		char MapName[40];
+	};
+
+	//Ids are PlayerIds, -1 for anything without a player
+	struct FSCombatEventRecord
+	{
+		//World time in seconds
+		float Time;
+
+		uint8_t Type;
+
+		uint8_t Flags;
+
+		uint16_t Aux;
+
+		int32_t Instigator;
+
+		int32_t Target;
+
+		float X;
+
+		float Y;
+
+		float Z;
+
+		float Value;
+	};
+
+	static_assert(sizeof(FSCombatEventFileHeader) == 64, "Header layout is part of the file format");
+	static_assert(sizeof(FSCombatEventRecord) == 32, "Record layout is part of the file format");
+}
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "SCombatEventFormat.h"
+
+class AActor;
+class IFileHandle;
+class FRunnableThread;
+class FEvent;
+
+using SCombatEventFormat::ESCombatEventType;
+using SCombatEventFormat::FSCombatEventRecord;
+
+/**
+ * Writes combat events of the running match to Saved/CombatEvents as fixed-size binary records. Every recording thread
+ * owns a single producer ring, a background thread drains all rings into the match file, so recording never formats,
+ * allocates or locks.
+ */
+class COOPLEARNING_API FSCombatEventRecorder : public FRunnable
+{
+public:
+
+	static FSCombatEventRecorder& Get();
+
+	~FSCombatEventRecorder();
+
+	//Server only. Opens a new file for the match and starts the flush thread, ends a match still running
+	void BeginMatch(const FString& MapName);
+
+	//Drains every ring, closes the file and stops the flush thread
+	void EndMatch();
+
+	bool IsRecording() const { return bRecording; }
+
+	//Any thread. Dropped and counted when the calling threads ring is full
+	void Record(ESCombatEventType Type, float Time, int32 Instigator, int32 Target, const FVector& Location, float Value = 0, uint16 Aux = 0);
+
+	//PlayerId of a pawn, controller or player state, -1 for everything else
+	static int32 GetActorId(const AActor* Actor);
+
+	virtual uint32 Run() override;
+
+	virtual void Stop() override;
+
+private:
+
+	FSCombatEventRecorder();
+
+	static const uint32 RingCapacity = 4096;
+
+	//Written by its thread only, read by the flush thread only
+	struct FSEventRing
+	{
+		FSCombatEventRecord Records[RingCapacity];
+
+		TAtomic<uint32> Head;
+
+		TAtomic<uint32> Tail;
+
+		FSEventRing() : Head(0), Tail(0) {}
+	};
+
+	FSEventRing& GetThreadRing();
+
+	uint32 TlsSlot;
+
+	//Rings live as long as the recorder, the lock is only taken when a thread records for the first time
+	TArray<FSEventRing*> Rings;
+
+	FCriticalSection RingsLock;
+
+	//Flush thread only
+	void Drain();
+
+	TArray<FSCombatEventRecord> WriteBuffer;
+
+	IFileHandle* File;
+
+	FRunnableThread* Thread;
+
+	FEvent* WakeEvent;
+
+	TAtomic<bool> bStopping;
+
+	TAtomic<bool> bRecording;
+};
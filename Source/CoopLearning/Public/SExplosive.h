@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "SExplosive.generated.h"
+
+UINTERFACE(MinimalAPI, meta = (CannotImplementInterfaceInBlueprint))
+class USExplosive : public UInterface
+{
+	GENERATED_BODY()
+};
+
+//Actors whose explosion cues are sent to clients in the batched multicast of USExplosionResolverComponent
+class COOPLEARNING_API ISExplosive
+{
+	GENERATED_BODY()
+
+public:
+
+	//Runs on every machine, Location is where the actor was when it went off
+	virtual void PlayExplosionEffects(const FVector& Location) {}
+};
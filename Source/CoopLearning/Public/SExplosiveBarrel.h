@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "SExplosive.h"
 #include "SExplosiveBarrel.generated.h"
 
 class USHealthComponent;
@@ -13,7 +14,7 @@ class USoundCue;
 class USoundAttenuation;
 
 UCLASS()
-class COOPLEARNING_API ASExplosiveBarrel : public AActor
+class COOPLEARNING_API ASExplosiveBarrel : public AActor, public ISExplosive
 {
 	GENERATED_BODY()
 	
@@ -55,12 +56,20 @@ protected:
 
 	bool bExploded;
 
-	UFUNCTION(NetMulticast, Reliable)
-	void MulticastExplode();
+	//How long the barrel stays awake for replication after being hit
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ExplosiveBarrel")
+	float DormancyDelay;
+
+	FTimerHandle TimerHandle_Dormancy;
+
+	void GoDormant();
 
 	UFUNCTION()
 	void OnHeathChanged(USHealthComponent* SourceHealthComp, float Health, float HealthDelta, const class UDamageType* DamageType, class AController* InstigatedBy, AActor* DamageCauser);
 
+public:
+
+	virtual void PlayExplosionEffects(const FVector& Location) override;
 
 
 };
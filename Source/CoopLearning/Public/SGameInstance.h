@@ -9,6 +9,7 @@
 
 
 class USUserSaveGame;
+class UDataTable;
 
 
 UCLASS()
@@ -20,8 +21,18 @@ public:
 
 	USGameInstance();
 
+	//Compiles the weapon DataTables into FSWeaponRegistry
+	virtual void Init() override;
+
 protected:
 
+	//Kept referenced for the whole session, the weapon registry points into their rows
+	UPROPERTY()
+	UDataTable* WeaponsDataTable;
+
+	UPROPERTY()
+	UDataTable* WeaponsSoundDataTable;
+
 	UPROPERTY(BlueprintReadWrite, Category = "GameInstance")
 	USUserSaveGame* UserSaveGame;
 
@@ -4,12 +4,24 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameMode.h"
+#include "SPickupGrid.h"
 #include "SGameMode.generated.h"
 
 
 class ASCharacter;
 class ASPlayerController;
 class APlayerState;
+class USLagCompensationComponent;
+class USActorPoolComponent;
+class APlayerStart;
+
+
+struct FSPendingRespawn
+{
+	TWeakObjectPtr<AController> Controller;
+
+	float DueTime = 0;
+};
 
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnPlayerDeathSignature, class ASPlayerController*, Dier, class ASPlayerController*, Killer);
@@ -36,12 +48,82 @@ protected:
 	UFUNCTION(Exec)
 	void EnableUnlimitedMags();
 
+	UFUNCTION(Exec)
+	void DumpActorPool();
+
+	//Drops Count copies of the first weapon class found in the world around the player starts, to watch the net stats with many idle pickups
+	UFUNCTION(Exec)
+	void SpawnBenchmarkWeapons(int32 Count);
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	USActorPoolComponent* ActorPoolComp;
+
+	UPROPERTY()
+	TArray<USLagCompensationComponent*> LagCompensatedComponents;
+
+	//Resting pickups shared by every character, server only
+	FSPickupGrid PickupGrid;
+
+	virtual void HandleMatchHasStarted() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	//PlayerStart positions as structure of arrays, padded to a multiple of 4 for the scoring kernel
+	void CachePlayerStarts();
+
+	UPROPERTY()
+	TArray<APlayerStart*> PlayerStarts;
+
+	TArray<float, TAlignedHeapAllocator<16>> PlayerStartX;
+
+	TArray<float, TAlignedHeapAllocator<16>> PlayerStartY;
+
+	TArray<float, TAlignedHeapAllocator<16>> PlayerStartZ;
+
+	//Characters spawn scoring keeps away from, registered on possess and dropped on death
+	TArray<TWeakObjectPtr<ASCharacter>> LivingCharacters;
+
+	//Positions of LivingCharacters, taken at most once per frame
+	void UpdateLivingCharacterSnapshot();
+
+	TArray<float> LivingCharacterX;
+
+	TArray<float> LivingCharacterY;
+
+	TArray<float> LivingCharacterZ;
+
+	uint64 LivingCharacterSnapshotFrame;
+
+	//Adds 1/sqrt(distance) from every given position to every PlayerStarts score, four starts per iteration
+	void AccumulateRespawnScores(const float* X, const float* Y, const float* Z, int32 Count, TArray<float, TAlignedHeapAllocator<16>>& InOutScores) const;
+
+	//Respawns waiting for their delay, in the order they were requested
+	TArray<FSPendingRespawn> RespawnQueue;
+
+	//Upper bound of pawns spawned per frame, due respawns over the budget wait for the next frame
+	UPROPERTY(EditDefaultsOnly, Category = "GameMode", meta = (ClampMin = 1))
+	int32 MaxRespawnsPerFrame;
+
+	void ProcessRespawnQueue();
+
+	void SpawnPlayerAt(AController* Player, AActor* PlayerStart);
+
+	//Active and dormant replicated actors as seen by the net driver, only while stats are collected
+	void UpdateNetObjectStats();
+
 public:
 
 	virtual void PostLogin(APlayerController* NewPlayer) override;
 
+	ASGameMode();
+
+	virtual void Tick(float DeltaSeconds) override;
+
 	AActor* ChoseBestRespawnPlayerStart(AController* Player);
 
+	//Resolves several respawns in one scoring pass, each pick counts as an occupied spot for the ones after it
+	void ChoseBestRespawnPlayerStarts(const TArray<AController*>& Players, TArray<AActor*>& OutPlayerStarts);
+
 	UFUNCTION(BlueprintCallable, Category = "GameMode")
 	void SetPlayerName(FString NewName, APlayerState* PlayerState);
 
@@ -55,6 +137,14 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "Events")
 	FOnPlayerDeathSignature OnPlayerDeath;
 
-	void RestartPlayerInProgress(AController * Player);
+	void RegisterLagCompensation(USLagCompensationComponent* Comp);
+
+	void UnregisterLagCompensation(USLagCompensationComponent* Comp);
+
+	const TArray<USLagCompensationComponent*>& GetLagCompensatedComponents() const;
+
+	FSPickupGrid& GetPickupGrid();
+
+	USActorPoolComponent* GetActorPool() const;
 
 };
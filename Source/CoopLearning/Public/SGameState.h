@@ -4,8 +4,13 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameState.h"
+#include "SScoreboard.h"
 #include "SGameState.generated.h"
 
+class USEffectPoolComponent;
+class USAudioDispatchComponent;
+class USFireSchedulerComponent;
+class USExplosionResolverComponent;
 
 UCLASS()
 class COOPLEARNING_API ASGameState : public AGameState
@@ -13,11 +18,68 @@ class COOPLEARNING_API ASGameState : public AGameState
 	GENERATED_BODY()
 	
 
+protected:
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	USEffectPoolComponent* EffectPoolComp;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	USAudioDispatchComponent* AudioDispatchComp;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	USFireSchedulerComponent* FireSchedulerComp;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	USExplosionResolverComponent* ExplosionResolverComp;
+
+	UPROPERTY(Replicated)
+	FSScoreboard Scoreboard;
+
+	//GetAllPlayersInfo text, rebuilt only when the scoreboard version moved
+	FString CachedPlayersInfo;
+
+	int32 CachedPlayersInfoVersion;
+
+	APlayerState* FindPlayerStateById(int32 PlayerId) const;
+
+	virtual void BeginPlay() override;
+
 public:
 
+	ASGameState();
+
+	USEffectPoolComponent* GetEffectPool() const;
+
+	USAudioDispatchComponent* GetAudioDispatch() const;
+
+	USFireSchedulerComponent* GetFireScheduler() const;
+
+	USExplosionResolverComponent* GetExplosionResolver() const;
+
 	UFUNCTION(BlueprintCallable, Category = "GameState")
 	FString GetAllPlayersInfo();
 
+	//Server only, called by ASPlayerState whenever its score changes
+	void UpdateScoreboard(APlayerState* PlayerState, int32 Kills, int32 Deaths, int32 KillsInARow, int32 DeathInARow);
+
+	virtual void AddPlayerState(APlayerState* PlayerState) override;
+
+	virtual void RemovePlayerState(APlayerState* PlayerState) override;
+
+	//Rows show player names, which arrive and change independently of the scores. Called on every machine
+	void MarkScoreboardNamesChanged();
+
+	//Changes whenever any row changed, rebuild the scoreboard widget only then
+	UFUNCTION(BlueprintPure, Category = "GameState")
+	int32 GetScoreboardVersion() const;
+
+	//Ranked rows, compare each RowVersion with the one last shown to skip unchanged rows
+	UFUNCTION(BlueprintCallable, Category = "GameState")
+	TArray<FSScoreboardRow> GetScoreboardRows() const;
+
+	UFUNCTION(BlueprintPure, Category = "GameState")
+	FString FormatScoreboardRow(const FSScoreboardRow& Row) const;
+
 	UPROPERTY(BlueprintReadOnly, Category = "GameState")
 	bool UnlimitedMags;
 
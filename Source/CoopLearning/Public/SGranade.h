@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "SPoolableActor.h"
+#include "SExplosive.h"
 #include "SGranade.generated.h"
 
 
@@ -13,7 +15,7 @@ class USoundCue;
 class USoundAttenuation;
 
 UCLASS()
-class COOPLEARNING_API ASGranade : public AActor
+class COOPLEARNING_API ASGranade : public AActor, public ISPoolableActor, public ISExplosive
 {
 	GENERATED_BODY()
 	
@@ -58,9 +60,6 @@ protected:
  	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Granade")
 	float ExplosionDefaultTime;
 
-	UFUNCTION(NetMulticast, Reliable)
-	void MulticastExplode();
-
 	UFUNCTION()
 	void OnHeathChanged(USHealthComponent* SourceHealthComp, float Health, float HealthDelta, const class UDamageType* DamageType, class AController* InstigatedBy, AActor* DamageCauser);
 
@@ -68,9 +67,31 @@ protected:
 
 	void DefaultExplode();
 
+	//Counts throws of this instance, clients play the spawn sound whenever it changes
+	UPROPERTY(ReplicatedUsing = OnRep_ThrowCount)
+	uint8 ThrowCount;
+
+	UFUNCTION()
+	void OnRep_ThrowCount();
+
+	void PlaySpawnSound();
+
+	bool bExploded;
+
+	FTimerHandle TimerHandle_Release;
+
+	//Short grace period so the explosion is resolved and replicated before the actor turns dormant
+	void ReleaseToPool();
+
 public:
 
 	void Explode(AController* InstigatedBy);
 
 	UStaticMeshComponent* GetMeshComp();
+
+	virtual void OnAcquiredFromPool() override;
+
+	virtual void OnReleasedToPool() override;
+
+	virtual void PlayExplosionEffects(const FVector& Location) override;
 };
@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "CoopLearning.h"
+
+CSV_DECLARE_CATEGORY_EXTERN(CoopLearning);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Weapon Fire"), STAT_CoopWeaponFire, STATGROUP_CoopLearning, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Pellet Traces"), STAT_CoopPelletTraces, STATGROUP_CoopLearning, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Character Tick"), STAT_CoopCharacterTick, STATGROUP_CoopLearning, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Respawn Scoring"), STAT_CoopRespawnScoring, STATGROUP_CoopLearning, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Explosions"), STAT_CoopExplosions, STATGROUP_CoopLearning, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Effect Spawns"), STAT_CoopEffectSpawns, STATGROUP_CoopLearning, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Sound Dispatch"), STAT_CoopSoundDispatch, STATGROUP_CoopLearning, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Fire Scheduler"), STAT_CoopFireScheduler, STATGROUP_CoopLearning, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Lag Compensation"), STAT_CoopLagCompensation, STATGROUP_CoopLearning, );
+
+//Gameplay hot paths, timed per frame for the percentiles of CoopHotPathStats
+enum class ESHotPath : uint8
+{
+	WeaponFire,
+	PelletTraces,
+	CharacterTick,
+	RespawnScoring,
+	Explosions,
+	EffectSpawns,
+	SoundDispatch,
+	FireScheduler,
+	LagCompensation,
+	Count
+};
+
+//Per frame counts, also shown in stat CoopLearning and the CSV profile
+enum class ESHotPathCounter : uint8
+{
+	Traces,
+	WeaponRPCs,
+	CharacterRPCs,
+	GameStateRPCs,
+	ActorsSpawned,
+	EffectsSpawned,
+	Count
+};
+
+/**
+ * Per match distribution of the time each hot path takes per frame, and of the counters. Samples go into
+ * quarter octave histograms so a long match needs no more memory than a short one, CoopHotPathStats prints
+ * p50/p90/p99/max without a profiler attached, which is what a dedicated server has.
+ */
+class COOPLEARNING_API FSHotPathStats
+{
+public:
+
+	//Clears the histograms, called when a match starts
+	static void ResetMatch();
+
+	//Game thread
+	static void AddCycles(ESHotPath Path, uint32 Cycles);
+
+	//Any thread
+	static void AddCount(ESHotPathCounter Counter, int32 Amount = 1);
+
+	static void Dump();
+};
+
+struct FSHotPathScope
+{
+	explicit FSHotPathScope(ESHotPath InPath)
+		: Path(InPath)
+		, StartCycles(FPlatformTime::Cycles())
+	{
+	}
+
+	~FSHotPathScope()
+	{
+		FSHotPathStats::AddCycles(Path, FPlatformTime::Cycles() - StartCycles);
+	}
+
+	ESHotPath Path;
+
+	uint32 StartCycles;
+};
+
+//Cycle counter for stat CoopLearning, CSV profiler timing and the per match percentiles in one
+#define COOP_HOT_PATH_SCOPE(Path) \
+	SCOPE_CYCLE_COUNTER(STAT_Coop##Path); \
+	CSV_SCOPED_TIMING_STAT(CoopLearning, Path); \
+	FSHotPathScope ANONYMOUS_VARIABLE(HotPathScope)(ESHotPath::Path)
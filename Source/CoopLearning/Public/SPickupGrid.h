@@ -0,0 +1,144 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+
+/**
+ * Uniform spatial hash over XY for things that can be picked up. Pickups are only inserted once they
+ * came to rest, so the grid changes rarely and a nearest query only has to look at a few cells.
+ */
+template<typename KeyType>
+class TSPickupGrid
+{
+public:
+
+	explicit TSPickupGrid(float InCellSize = 500.0f)
+		: CellSize(InCellSize)
+		, Version(0)
+	{
+	}
+
+	//Inserts the pickup or moves it if it is already in the grid
+	void Add(KeyType Pickup, const FVector& Location)
+	{
+		FIntPoint Cell = GetCell(Location);
+		FIntPoint* OldCell = PickupCells.Find(Pickup);
+
+		if (OldCell)
+		{
+			if (*OldCell == Cell)
+			{
+				FEntry* Entry = Cells[Cell].FindByPredicate([Pickup](const FEntry& Other) { return Other.Pickup == Pickup; });
+				Entry->Location = Location;
+				Version++;
+				return;
+			}
+
+			RemoveFromCell(Pickup, *OldCell);
+		}
+
+		Cells.FindOrAdd(Cell).Add({ Pickup, Location });
+		PickupCells.Add(Pickup, Cell);
+		Version++;
+	}
+
+	void Remove(KeyType Pickup)
+	{
+		FIntPoint Cell;
+
+		if (PickupCells.RemoveAndCopyValue(Pickup, Cell))
+		{
+			RemoveFromCell(Pickup, Cell);
+			Version++;
+		}
+	}
+
+	bool Contains(KeyType Pickup) const
+	{
+		return PickupCells.Contains(Pickup);
+	}
+
+	//Closest pickup within Radius of Location that passes Filter, looks at a 3x3 block of cells while Radius <= CellSize
+	template<typename FilterType>
+	KeyType FindNearest(const FVector& Location, float Radius, FilterType&& Filter) const
+	{
+		KeyType Nearest = KeyType();
+		float NearestDistSq = Radius * Radius;
+
+		const FIntPoint Center = GetCell(Location);
+		const int32 CellRange = FMath::Max(1, FMath::CeilToInt(Radius / CellSize));
+
+		for (int32 X = Center.X - CellRange; X <= Center.X + CellRange; X++)
+		{
+			for (int32 Y = Center.Y - CellRange; Y <= Center.Y + CellRange; Y++)
+			{
+				const TArray<FEntry>* Entries = Cells.Find(FIntPoint(X, Y));
+
+				if (!Entries)
+				{
+					continue;
+				}
+
+				for (const FEntry& Entry : *Entries)
+				{
+					float DistSq = FVector::DistSquared(Location, Entry.Location);
+
+					if (DistSq <= NearestDistSq && Filter(Entry.Pickup))
+					{
+						NearestDistSq = DistSq;
+						Nearest = Entry.Pickup;
+					}
+				}
+			}
+		}
+
+		return Nearest;
+	}
+
+	//Changes every time a pickup is added, moved or removed
+	uint32 GetVersion() const { return Version; }
+
+	int32 Num() const { return PickupCells.Num(); }
+
+protected:
+
+	struct FEntry
+	{
+		KeyType Pickup;
+
+		FVector Location;
+	};
+
+	float CellSize;
+
+	uint32 Version;
+
+	TMap<FIntPoint, TArray<FEntry>> Cells;
+
+	TMap<KeyType, FIntPoint> PickupCells;
+
+	FIntPoint GetCell(const FVector& Location) const
+	{
+		return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+	}
+
+	void RemoveFromCell(KeyType Pickup, const FIntPoint& Cell)
+	{
+		TArray<FEntry>* Entries = Cells.Find(Cell);
+
+		if (Entries)
+		{
+			Entries->RemoveAllSwap([Pickup](const FEntry& Entry) { return Entry.Pickup == Pickup; });
+
+			if (Entries->Num() == 0)
+			{
+				Cells.Remove(Cell);
+			}
+		}
+	}
+};
+
+typedef TSPickupGrid<AActor*> FSPickupGrid;
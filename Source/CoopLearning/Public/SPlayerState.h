@@ -30,7 +30,12 @@ protected:
 	UPROPERTY(Replicated, BlueprintReadOnly)
 	int MaterialId;
 
+	void MarkScoreboardNameChanged();
+
 public:
+	ASPlayerState();
+
+	//All writes below force a net update, the 4.23 stand-in for push model dirty marking
 	UFUNCTION(BlueprintCallable)
 		void AddKill();
 
@@ -51,5 +56,10 @@ public:
 
 	UFUNCTION(BlueprintCallable)
 		void SetMaterialId(int NewMaterialId);
+
+	//Pushes the score into the GameStates replicated scoreboard, server only
+	void UpdateScoreboard();
+
+	virtual void OnRep_PlayerName() override;
 };
 
@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "SPoolableActor.generated.h"
+
+UINTERFACE(MinimalAPI, meta = (CannotImplementInterfaceInBlueprint))
+class USPoolableActor : public UInterface
+{
+	GENERATED_BODY()
+};
+
+//Actors recycled by USActorPoolComponent, the pool handles visibility, collision, ticking and dormancy
+class COOPLEARNING_API ISPoolableActor
+{
+	GENERATED_BODY()
+
+public:
+
+	//Called after the actor is moved to its new transform and woken up, also right after a pool miss spawned it. Reset gameplay state here
+	virtual void OnAcquiredFromPool() {}
+
+	//Called before the actor is hidden and put to sleep, stop timers and leave shared systems here
+	virtual void OnReleasedToPool() {}
+};
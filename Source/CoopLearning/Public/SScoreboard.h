@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "SScoreboard.generated.h"
+
+struct FSScoreboard;
+
+//Score of one player, replicated as a fast array item so only changed rows go over the wire
+USTRUCT(BlueprintType)
+struct FSScoreboardRow : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Scoreboard")
+	int32 PlayerId = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Scoreboard")
+	int32 Kills = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Scoreboard")
+	int32 Deaths = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Scoreboard")
+	int32 KillsInARow = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Scoreboard")
+	int32 DeathInARow = 0;
+
+	//Scoreboard version of the last change to this row, widgets only reformat rows whose RowVersion moved
+	UPROPERTY(NotReplicated, BlueprintReadOnly, Category = "Scoreboard")
+	int32 RowVersion = 0;
+
+	void PostReplicatedAdd(const FSScoreboard& InArraySerializer);
+
+	void PostReplicatedChange(const FSScoreboard& InArraySerializer);
+
+	void PreReplicatedRemove(const FSScoreboard& InArraySerializer);
+};
+
+/**
+ * Replicated scores of all players. Rows arrive in any order on clients, and a kill changes two rows in one
+ * update whose callbacks only run after both were written, so changes just mark the local ranking dirty and
+ * it gets sorted once on the next read. There are never more rows than players.
+ */
+USTRUCT()
+struct FSScoreboard : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FSScoreboardRow> Rows;
+
+	//Server only, adds the row on first use
+	void SetScore(int32 PlayerId, int32 Kills, int32 Deaths, int32 KillsInARow, int32 DeathInARow);
+
+	//Server only
+	void RemovePlayer(int32 PlayerId);
+
+	const FSScoreboardRow* FindRow(int32 PlayerId) const;
+
+	//Player ids, most kills first, fewer deaths break ties
+	const TArray<int32>& GetRanking() const;
+
+	//Bumped on every change on this machine
+	int32 GetVersion() const { return Version; }
+
+	//Something shown next to every row changed, like player names, bumps the version and every RowVersion
+	void MarkAllRowsChanged();
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FSScoreboardRow, FSScoreboard>(Rows, DeltaParms, *this);
+	}
+
+private:
+
+	friend struct FSScoreboardRow;
+
+	//Local bookkeeping, mutable because the replication callbacks only get a const serializer
+	mutable TArray<int32> Ranking;
+
+	mutable int32 Version = 0;
+
+	mutable bool bRankingDirty = false;
+
+	bool IsRankedBefore(const FSScoreboardRow& A, const FSScoreboardRow& B) const;
+
+	//Marks the ranking dirty and returns the new version
+	int32 OnRowChanged(const FSScoreboardRow& Row) const;
+
+	void OnRowRemoved(int32 PlayerId) const;
+};
+
+template<>
+struct TStructOpsTypeTraits<FSScoreboard> : public TStructOpsTypeTraitsBase2<FSScoreboard>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
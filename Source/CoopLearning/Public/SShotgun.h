@@ -14,9 +14,11 @@ class COOPLEARNING_API ASShotgun : public ASWeapon
 {
 	GENERATED_BODY()
 	
-protected:
+public:
+
+	virtual int32 GetPelletsPerShot() const override;
 
-	virtual void StartFire() override;
+protected:
 
 	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
 	int PelletsPerShot;
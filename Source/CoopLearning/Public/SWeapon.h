@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Engine/DataTable.h"
+#include "SPoolableActor.h"
 #include "SWeapon.generated.h"
 
 class USkeletalMeshComponent;
@@ -12,8 +13,22 @@ class UDamageType;
 class UParticleSystem;
 class UCameraShake;
 class USoundCue;
-class UDataTable;
 class USoundAttenuation;
+struct FSWeaponHotStats;
+
+//Drives how often the server replicates a weapon
+UENUM()
+enum class ESWeaponNetState : uint8
+{
+	//Not tracked, in the pool or not initialized
+	None,
+	//Attached to a character, ammo is pushed on change
+	Equipped,
+	//Thrown and simulating physics
+	Dropped,
+	//Asleep on the floor, dormant until picked up
+	Idle
+};
 
 USTRUCT(BlueprintType)
 struct FWeaponData : public FTableRowBase
@@ -88,6 +103,33 @@ public:
 };
 
 
+//Max pellets a single volley packet can carry
+#define MAX_PELLETS_PER_VOLLEY 64
+
+struct FMulticastPelletData
+{
+	bool HitTarget = false;
+
+	//Impact point if HitTarget, otherwise where the tracer ends. Only impact points are sent, misses are rebuilt from the spread stream
+	FVector TraceEndPoint = FVector::ZeroVector;
+
+	FVector ImpactNormal = FVector::ZeroVector;
+
+	TEnumAsByte<EPhysicalSurface> SurfaceType = SurfaceType_Default;
+};
+
+//Volleys the owning client remembers having predicted, enough to cover several round trips of the fastest weapon
+#define PREDICTED_VOLLEY_HISTORY 16
+
+struct FPredictedVolley
+{
+	int32 ShotIndex = INDEX_NONE;
+
+	//Which pellets already showed an impact locally
+	uint64 HitMask = 0;
+};
+
+//Everything clients need to play one volley, sent as a single unreliable multicast with a hand packed layout
 USTRUCT()
 struct FMulticastShotData 
 {
@@ -96,26 +138,67 @@ struct FMulticastShotData
 public:
 
 	UPROPERTY()
-	bool HitTarget;
+	bool NoShot;
 
-	UPROPERTY()
-	FVector_NetQuantize TraceEndPoint;
+	//Index into the weapons spread stream, clients expand the pellet directions from it and the replicated SpreadSeed
+	int32 ShotIndex = 0;
 
-	UPROPERTY()
-	FVector_NetQuantize ImpactPoint;
+	FVector TraceStart = FVector::ZeroVector;
 
-	UPROPERTY()
-	FVector_NetQuantizeNormal ImpactNormal;
+	FRotator AimRotation = FRotator::ZeroRotator;
 
-	UPROPERTY()
-	TEnumAsByte<EPhysicalSurface> SurfaceType;
+	float SpreadAmount = 0;
 
-	UPROPERTY()
-	bool NoShot;
+	TArray<FMulticastPelletData, TInlineAllocator<16>> Pellets;
+
+	//Rounds the aim to what survives NetSerialize so everyone expands the exact same pellet directions
+	void QuantizeAim();
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FMulticastShotData> : public TStructOpsTypeTraitsBase2<FMulticastShotData>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+//Result of one pellet of a volley, filled by the trace jobs and read back on the game thread
+struct FPelletTraceResult
+{
+	FVector Direction;
+
+	FVector TraceEnd;
+
+	FVector TracerEnd;
+
+	FHitResult Hit;
+
+	bool bHit = false;
+
+	EPhysicalSurface SurfaceType = SurfaceType_Default;
+};
+
+//Socket resolved to its bone once, its world transform computed at most once per frame
+struct FSCachedSocket
+{
+	FName Name;
+
+	int32 BoneIndex = INDEX_NONE;
+
+	//Socket offset from its bone, identity when the name is a bone and not a socket
+	FTransform RelativeTransform;
+
+	FTransform WorldTransform;
+
+	uint64 Frame = MAX_uint64;
 };
 
 UCLASS()
-class COOPLEARNING_API ASWeapon : public AActor
+class COOPLEARNING_API ASWeapon : public AActor, public ISPoolableActor
 {
 	GENERATED_BODY()
 	
@@ -128,14 +211,39 @@ protected:
 
 	virtual void BeginPlay() override;
 
-	UDataTable* WeaponsDataTable;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	//Dropped weapons become pickups once physics puts them to sleep
+	UFUNCTION()
+	void OnMeshSleep(UPrimitiveComponent* SleepingComponent, FName BoneName);
 
-	UDataTable* WeaponsSoundDataTable;
+	//Explosions and collisions wake resting pickups, they are moving again until the next sleep
+	UFUNCTION()
+	void OnMeshWake(UPrimitiveComponent* WakingComponent, FName BoneName);
 
-	UPROPERTY(BlueprintReadOnly, Category = "Weapon")
-	FWeaponData WeaponsData;
+	void AddToPickupGrid();
 
-	FWeaponSoundData* WeaponsSoundData;
+	void RemoveFromPickupGrid();
+
+	//Base rate, used while a dropped weapon is flying
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
+	float DroppedNetUpdateFrequency;
+
+	//Held weapons follow the replicated owner and only change with shots and reloads, which force an update
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
+	float EquippedNetUpdateFrequency;
+
+	ESWeaponNetState NetState;
+
+	//Server only, applies update rate and dormancy of the new state
+	void SetNetState(ESWeaponNetState NewState);
+
+	//Entry of WeaponsDataName in FSWeaponRegistry, resolved in BeginPlay
+	int32 WeaponIndex;
+
+	const FSWeaponHotStats& GetStats() const;
+
+	const FWeaponSoundData& GetSounds() const;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
 	FName WeaponsDataName;
@@ -143,7 +251,7 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
 	USkeletalMeshComponent* MeshComp;
 
-	void PlayFireEffects(FVector TracerEndPoint);
+	void PlayFireEffects(const FMulticastShotData& ShotData);
 
 	void PlayImpactEffects(FVector ImpactPoint, FVector ImpactNormal, EPhysicalSurface SurfaceType);
 
@@ -155,6 +263,21 @@ protected:
 
 	UPROPERTY(VisibleDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
 	FName TracerTargetName;
+
+	FSCachedSocket MuzzleSocket;
+
+	FSCachedSocket CenterSocket;
+
+	void ResolveSocket(FSCachedSocket& Cache, FName SocketName);
+
+	const FTransform& GetCachedSocketTransform(FSCachedSocket& Cache);
+
+	//Attaching or detaching moves the sockets within the frame
+	void InvalidateSocketCache();
+
+	FVector GetMuzzleLocation();
+
+	FVector GetCenterLocation();
 	
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
 	UParticleSystem* MuzzleEffect;
@@ -185,17 +308,58 @@ protected:
 
 	void Fire(int  PelletsAmount);
 
+	void FireVolley(int PelletsAmount, int32 ShotIndex, float RewindTime);
+
+	void PredictVolley(int PelletsAmount, int32 ShotIndex);
+
+	bool IsMuzzleBlocked(const FCollisionQueryParams& QueryParams, FVector& OutWeaponMuzzle);
+
+	void ComputeVolleyAim(AActor* MyOwner, int32 ShotIndex, FMulticastShotData& OutShotData);
+
+	void ExpandPelletDirections(const FMulticastShotData& ShotData, int PelletsAmount, TArray<FPelletTraceResult>& OutResults);
+
+	void TracePellets(const FVector& TraceStart, const FVector& WeaponMuzzle, const FCollisionQueryParams& QueryParams, TArray<FPelletTraceResult>& InOutResults);
+
+	void FillVolleyPellets(const TArray<FPelletTraceResult>& Results, FMulticastShotData& OutShotData);
+
+	void ApplyPelletDamage(AActor* MyOwner, const TArray<FPelletTraceResult>& Results);
+
+	//Reused between volleys so firing does not allocate
+	TArray<FPelletTraceResult> PelletResults;
+
+	//ClientTime is the server time the client saw when firing, hitboxes get rewound to it. ShotIndex is only the clients prediction, the server counts shots itself
 	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerFire(int PelletsAmount);
+	void ServerFire(int PelletsAmount, int32 ShotIndex, float ClientTime);
 
-	UFUNCTION(NetMulticast, Reliable)
-	void MultiCastFire(FMulticastShotData MulticastData);
+	//Seeds the deterministic spread stream, rerolled every time the weapon is equipped
+	UPROPERTY(ReplicatedUsing = OnRep_SpreadSeed)
+	int32 SpreadSeed;
+
+	//Owning client: the seed of the current owner arrived, until then the server volleys are played instead of predicting
+	bool bSpreadSeedArmed;
+
+	UFUNCTION()
+	void OnRep_SpreadSeed();
+
+	virtual void OnRep_Owner() override;
+
+	//Shots since equip, counted on the server and on the owning client. Both restart with every new SpreadSeed
+	int32 ShotCounter;
+
+	//Slot ShotIndex % PREDICTED_VOLLEY_HISTORY, several volleys are in flight whenever the RTT exceeds TimeBetweenShots
+	FPredictedVolley PredictedVolleys[PREDICTED_VOLLEY_HISTORY];
+
+	const FPredictedVolley* FindPredictedVolley(int32 ShotIndex) const;
+
+	//Unreliable so volleys never queue up in the reliable buffer, and the net driver drops it for connections the weapon is not relevant to
+	UFUNCTION(NetMulticast, Unreliable)
+	void MultiCastFire(const FMulticastShotData& MulticastData);
+
+	void RecordShotNetStats(const FMulticastShotData& MulticastData);
 
 	UFUNCTION(Server, Reliable, WithValidation)
 	void ServerReload();
 
-	FTimerHandle TimerHandle_TimeBetweenShots;
-
 	float LastFireTimeStamp;
 
 	float TimeBetweenShots;
@@ -209,6 +373,11 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
 	float DespawnTime;
 
+	FTimerHandle TimerHandle_Despawn;
+
+	//Dropped weapon expired, back into the GameModes pool
+	void Despawn();
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
 	float SpeedEqualToMaxSpread;
 
@@ -221,6 +390,12 @@ protected:
 public:
 	virtual void StartFire();
 
+	//Called by USFireSchedulerComponent for every shot due while the trigger is held
+	void FireScheduledShot();
+
+	//Pellets of one volley
+	virtual int32 GetPelletsPerShot() const;
+
 	virtual void StopFire();
 
 	void GetEquippedBy(AActor* NewOwner);
@@ -232,4 +407,15 @@ public:
 	bool CanReload();
 
 	float GetReloadTime();
+
+	//Full DataTable row of this weapon type, for UI. Read straight from the registry, weapons hold no copy
+	UFUNCTION(BlueprintPure, Category = "Weapon")
+	const FWeaponData& GetWeaponsData() const;
+
+	//Times the socket queries of one volley with and without the cache
+	void BenchmarkSocketCache(int32 Iterations);
+
+	virtual void OnAcquiredFromPool() override;
+
+	virtual void OnReleasedToPool() override;
 };
\ No newline at end of file
@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SWeapon.h"
+
+class UDataTable;
+class UDamageType;
+
+//Fields read on the fire path, packed densely so weapons of one type share a single cache friendly entry
+struct FSWeaponHotStats
+{
+	float BaseDamage = 0;
+
+	float HeadshotMultiplyer = 1;
+
+	float WeakshotMultiplyer = 1;
+
+	float RateOfFire = 0;
+
+	//Precomputed from RateOfFire
+	float TimeBetweenShots = 0;
+
+	float HitMaxDistance = 0;
+
+	float BaseSpreadInDegrees = 0;
+
+	float MaxSpreadInDegrees = 0;
+
+	float ThrowForce = 0;
+
+	float ReloadTime = 0;
+
+	int32 BulletsPerMagazine = 0;
+
+	int32 DefaultMagazineCount = 0;
+
+	UClass* DamageType = nullptr;
+};
+
+/**
+ * Weapon DataTables compiled once at startup into index addressed arrays. Weapons only keep their index,
+ * the hot array holds what firing needs, sounds and the full rows (names, icons) live in separate arrays.
+ * The DataTables themselves are kept alive by USGameInstance, which also owns every asset referenced here.
+ */
+class COOPLEARNING_API FSWeaponRegistry
+{
+public:
+
+	static FSWeaponRegistry& Get();
+
+	//Every game instance builds it, PIE runs several at once. Rows keep their index across builds, so weapons of running worlds stay valid
+	void Build(const UDataTable* WeaponsTable, const UDataTable* SoundsTable);
+
+	//INDEX_NONE if the name has no row in both tables
+	int32 FindIndex(FName WeaponName) const;
+
+	bool IsValidIndex(int32 Index) const { return HotStats.IsValidIndex(Index); }
+
+	const FSWeaponHotStats& GetHotStats(int32 Index) const { return HotStats[Index]; }
+
+	const FWeaponSoundData& GetSounds(int32 Index) const { return Sounds[Index]; }
+
+	const FWeaponData& GetColdData(int32 Index) const { return ColdData[Index]; }
+
+	int32 Num() const { return HotStats.Num(); }
+
+protected:
+
+	TArray<FSWeaponHotStats> HotStats;
+
+	TArray<FWeaponSoundData> Sounds;
+
+	TArray<FWeaponData> ColdData;
+
+	TMap<FName, int32> IndexByName;
+};
@@ -0,0 +1,157 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EventFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace CombatEventReader
+{
+	namespace
+	{
+		const char* EventTypeNames[] = { "shot", "hit", "damage", "death", "explosion", "respawn" };
+
+		const int EventTypeCount = sizeof(EventTypeNames) / sizeof(EventTypeNames[0]);
+	}
+
+	FEventFile::~FEventFile()
+	{
+		Close();
+	}
+
+	bool FEventFile::Open(const std::string& Path, std::string& OutError)
+	{
+		Close();
+
+#ifdef _WIN32
+		HANDLE File = CreateFileA(Path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+		if (File == INVALID_HANDLE_VALUE)
+		{
+			OutError = "cannot open " + Path;
+			return false;
+		}
+
+		FileHandle = File;
+
+		LARGE_INTEGER FileSize;
+		GetFileSizeEx(File, &FileSize);
+		Size = (size_t)FileSize.QuadPart;
+
+		if (Size > 0)
+		{
+			MappingHandle = CreateFileMappingA(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			Data = MappingHandle ? (const unsigned char*)MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+		}
+#else
+		FileDescriptor = open(Path.c_str(), O_RDONLY);
+
+		if (FileDescriptor < 0)
+		{
+			OutError = "cannot open " + Path;
+			return false;
+		}
+
+		struct stat FileStat;
+		fstat(FileDescriptor, &FileStat);
+		Size = (size_t)FileStat.st_size;
+
+		if (Size > 0)
+		{
+			void* Mapping = mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, FileDescriptor, 0);
+			Data = Mapping != MAP_FAILED ? (const unsigned char*)Mapping : nullptr;
+		}
+#endif
+
+		if (!Data || Size < sizeof(FSCombatEventFileHeader))
+		{
+			OutError = Path + " is too small for a combat event log";
+			Close();
+			return false;
+		}
+
+		const FSCombatEventFileHeader& Header = GetHeader();
+
+		if (Header.Magic != SCombatEventFormat::Magic)
+		{
+			OutError = Path + " is not a combat event log";
+			Close();
+			return false;
+		}
+
+		if (Header.Version != SCombatEventFormat::Version || Header.RecordSize != sizeof(FSCombatEventRecord) || Header.HeaderSize < sizeof(FSCombatEventFileHeader) || Header.HeaderSize > Size)
+		{
+			OutError = Path + " was written by another version of the recorder";
+			Close();
+			return false;
+		}
+
+		RecordCount = (Size - Header.HeaderSize) / Header.RecordSize;
+
+		return true;
+	}
+
+	void FEventFile::Close()
+	{
+#ifdef _WIN32
+		if (Data)
+		{
+			UnmapViewOfFile(Data);
+		}
+
+		if (MappingHandle)
+		{
+			CloseHandle(MappingHandle);
+			MappingHandle = nullptr;
+		}
+
+		if (FileHandle)
+		{
+			CloseHandle(FileHandle);
+			FileHandle = nullptr;
+		}
+#else
+		if (Data)
+		{
+			munmap((void*)Data, Size);
+		}
+
+		if (FileDescriptor >= 0)
+		{
+			close(FileDescriptor);
+			FileDescriptor = -1;
+		}
+#endif
+
+		Data = nullptr;
+		Size = 0;
+		RecordCount = 0;
+	}
+
+	const char* GetEventTypeName(ESCombatEventType Type)
+	{
+		int Index = (int)Type;
+		return Index < EventTypeCount ? EventTypeNames[Index] : "unknown";
+	}
+
+	bool ParseEventType(const std::string& Name, ESCombatEventType& OutType)
+	{
+		for (int i = 0; i < EventTypeCount; i++)
+		{
+			if (Name == EventTypeNames[i])
+			{
+				OutType = (ESCombatEventType)i;
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "SCombatEventFormat.h"
+
+#include <cstddef>
+#include <string>
+
+namespace CombatEventReader
+{
+	using SCombatEventFormat::ESCombatEventType;
+	using SCombatEventFormat::FSCombatEventFileHeader;
+	using SCombatEventFormat::FSCombatEventRecord;
+
+	//Read only memory mapping of one .scev file, records are used in place
+	class FEventFile
+	{
+	public:
+
+		FEventFile() = default;
+
+		~FEventFile();
+
+		FEventFile(const FEventFile&) = delete;
+
+		FEventFile& operator=(const FEventFile&) = delete;
+
+		//False with OutError set when the file is missing, not a combat event log or of another version
+		bool Open(const std::string& Path, std::string& OutError);
+
+		const FSCombatEventFileHeader& GetHeader() const { return *reinterpret_cast<const FSCombatEventFileHeader*>(Data); }
+
+		const FSCombatEventRecord* GetRecords() const { return reinterpret_cast<const FSCombatEventRecord*>(Data + GetHeader().HeaderSize); }
+
+		//A record cut off by a crash mid write is left out
+		size_t GetRecordCount() const { return RecordCount; }
+
+	private:
+
+		void Close();
+
+		const unsigned char* Data = nullptr;
+
+		size_t Size = 0;
+
+		size_t RecordCount = 0;
+
+#ifdef _WIN32
+		void* FileHandle = nullptr;
+
+		void* MappingHandle = nullptr;
+#else
+		int FileDescriptor = -1;
+#endif
+	};
+
+	const char* GetEventTypeName(ESCombatEventType Type);
+
+	//Accepts the names printed by GetEventTypeName, case sensitive
+	bool ParseEventType(const std::string& Name, ESCombatEventType& OutType);
+}
@@ -0,0 +1,228 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EventFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+
+using namespace CombatEventReader;
+
+namespace
+{
+	void PrintUsage()
+	{
+		std::printf(
+			"Usage: CombatEventReader <command> <file.scev> [options]\n"
+			"  summary                Match info and event counts per type\n"
+			"  killfeed               Every death in order, with killer, victim and place\n"
+			"  heatmap                Event density over the XY plane\n"
+			"    --type <name>        shot, hit, damage, death, explosion or respawn (default death)\n"
+			"    --cell <cm>          Cell size (default 500)\n"
+			"    --csv                Print cell,count rows instead of a character map\n");
+	}
+
+	std::string FormatPlayer(int32_t PlayerId)
+	{
+		return PlayerId < 0 ? std::string("world") : "player " + std::to_string(PlayerId);
+	}
+
+	std::string FormatTime(float Seconds)
+	{
+		int Total = (int)Seconds;
+		char Buffer[32];
+		std::snprintf(Buffer, sizeof(Buffer), "%02d:%02d.%01d", Total / 60, Total % 60, (int)((Seconds - Total) * 10));
+		return Buffer;
+	}
+
+	void PrintSummary(const FEventFile& File)
+	{
+		const FSCombatEventFileHeader& Header = File.GetHeader();
+		const FSCombatEventRecord* Records = File.GetRecords();
+
+		size_t Counts[6] = {};
+		float FirstTime = 0;
+		float LastTime = 0;
+
+		for (size_t i = 0; i < File.GetRecordCount(); i++)
+		{
+			if (Records[i].Type < 6)
+			{
+				Counts[Records[i].Type]++;
+			}
+
+			FirstTime = i == 0 ? Records[i].Time : std::min(FirstTime, Records[i].Time);
+			LastTime = std::max(LastTime, Records[i].Time);
+		}
+
+		std::printf("Map %.40s, started at unix time %lld, %zu events over %.1f s\n", Header.MapName, (long long)Header.StartUnixTime, File.GetRecordCount(), LastTime - FirstTime);
+
+		for (int Type = 0; Type < 6; Type++)
+		{
+			std::printf("  %-10s %zu\n", GetEventTypeName((ESCombatEventType)Type), Counts[Type]);
+		}
+	}
+
+	void PrintKillFeed(const FEventFile& File)
+	{
+		const FSCombatEventRecord* Records = File.GetRecords();
+
+		for (size_t i = 0; i < File.GetRecordCount(); i++)
+		{
+			const FSCombatEventRecord& Record = Records[i];
+
+			if (Record.Type != (uint8_t)ESCombatEventType::Death)
+			{
+				continue;
+			}
+
+			std::printf("%s  %s killed %s at (%.0f, %.0f, %.0f)\n", FormatTime(Record.Time).c_str(), FormatPlayer(Record.Instigator).c_str(), FormatPlayer(Record.Target).c_str(), Record.X, Record.Y, Record.Z);
+		}
+	}
+
+	void PrintHeatmap(const FEventFile& File, ESCombatEventType Type, float CellSize, bool bCsv)
+	{
+		const FSCombatEventRecord* Records = File.GetRecords();
+		std::map<std::pair<int, int>, int> Cells;
+		int MaxCount = 0;
+
+		for (size_t i = 0; i < File.GetRecordCount(); i++)
+		{
+			const FSCombatEventRecord& Record = Records[i];
+
+			if (Record.Type != (uint8_t)Type)
+			{
+				continue;
+			}
+
+			std::pair<int, int> Cell((int)std::floor(Record.X / CellSize), (int)std::floor(Record.Y / CellSize));
+			MaxCount = std::max(MaxCount, ++Cells[Cell]);
+		}
+
+		if (Cells.empty())
+		{
+			std::printf("No %s events\n", GetEventTypeName(Type));
+			return;
+		}
+
+		if (bCsv)
+		{
+			std::printf("x,y,count\n");
+
+			for (const auto& Cell : Cells)
+			{
+				std::printf("%.0f,%.0f,%d\n", Cell.first.first * CellSize, Cell.first.second * CellSize, Cell.second);
+			}
+
+			return;
+		}
+
+		int MinX = Cells.begin()->first.first;
+		int MaxX = MinX;
+		int MinY = Cells.begin()->first.second;
+		int MaxY = MinY;
+
+		for (const auto& Cell : Cells)
+		{
+			MinX = std::min(MinX, Cell.first.first);
+			MaxX = std::max(MaxX, Cell.first.first);
+			MinY = std::min(MinY, Cell.first.second);
+			MaxY = std::max(MaxY, Cell.first.second);
+		}
+
+		const char Ramp[] = " .:-=+*#%@";
+		const int RampSteps = (int)std::strlen(Ramp) - 1;
+
+		std::printf("%s events, one character per %.0f cm, X to the right, Y up, densest cell %d\n", GetEventTypeName(Type), CellSize, MaxCount);
+
+		for (int Y = MaxY; Y >= MinY; Y--)
+		{
+			std::string Line;
+
+			for (int X = MinX; X <= MaxX; X++)
+			{
+				auto It = Cells.find(std::make_pair(X, Y));
+				int Count = It != Cells.end() ? It->second : 0;
+				Line += Ramp[Count == 0 ? 0 : std::max(1, (Count * RampSteps + MaxCount - 1) / MaxCount)];
+			}
+
+			std::printf("%s\n", Line.c_str());
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		PrintUsage();
+		return argc > 1 && std::strcmp(argv[1], "--help") == 0 ? 0 : 1;
+	}
+
+	std::string Command = argv[1];
+	ESCombatEventType HeatmapType = ESCombatEventType::Death;
+	float CellSize = 500;
+	bool bCsv = false;
+
+	for (int i = 3; i < argc; i++)
+	{
+		std::string Arg = argv[i];
+		bool bHasValue = i + 1 < argc;
+
+		if (Arg == "--type" && bHasValue)
+		{
+			if (!ParseEventType(argv[++i], HeatmapType))
+			{
+				std::fprintf(stderr, "Unknown event type %s\n", argv[i]);
+				return 1;
+			}
+		}
+		else if (Arg == "--cell" && bHasValue)
+		{
+			CellSize = std::max(1.0f, (float)std::atof(argv[++i]));
+		}
+		else if (Arg == "--csv")
+		{
+			bCsv = true;
+		}
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	FEventFile File;
+	std::string Error;
+
+	if (!File.Open(argv[2], Error))
+	{
+		std::fprintf(stderr, "%s\n", Error.c_str());
+		return 1;
+	}
+
+	if (Command == "summary")
+	{
+		PrintSummary(File);
+	}
+	else if (Command == "killfeed")
+	{
+		PrintKillFeed(File);
+	}
+	else if (Command == "heatmap")
+	{
+		PrintHeatmap(File, HeatmapType, CellSize, bCsv);
+	}
+	else
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,319 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EngagementSim.h"
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace WeaponBalanceSim
+{
+	namespace
+	{
+		const float Pi = 3.14159265358979f;
+
+		uint64_t SplitMix64(uint64_t& State)
+		{
+			uint64_t Value = (State += 0x9E3779B97F4A7C15ull);
+			Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+			Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+			return Value ^ (Value >> 31);
+		}
+
+		uint64_t RotateLeft(uint64_t Value, int Bits)
+		{
+			return (Value << Bits) | (Value >> (64 - Bits));
+		}
+
+		//Capsule standing upright, seen from the side. Y is horizontal, Z vertical, both relative to its center
+		bool HitsCapsule(float Y, float Z, float Radius, float HalfHeight)
+		{
+			float CylinderHalfHeight = HalfHeight - Radius;
+			float CapZ = std::max(std::fabs(Z) - CylinderHalfHeight, 0.0f);
+
+			return Y * Y + CapZ * CapZ <= Radius * Radius;
+		}
+
+		float Percentile(std::vector<float>& Sorted, float Fraction)
+		{
+			if (Sorted.empty())
+			{
+				return 0;
+			}
+
+			size_t Index = (size_t)std::floor(Fraction * (Sorted.size() - 1));
+			return Sorted[Index];
+		}
+
+		//Partial sums of one task, merged in task order so the totals do not depend on scheduling
+		struct FTaskTotals
+		{
+			uint64_t Kills = 0;
+
+			double TimeToKillSum = 0;
+
+			uint64_t Shots = 0;
+
+			uint64_t PelletsFired = 0;
+
+			uint64_t PelletsHit = 0;
+
+			uint64_t Headshots = 0;
+
+			uint64_t Reloads = 0;
+		};
+	}
+
+	FRandom::FRandom(uint64_t Seed)
+	{
+		for (uint64_t& Word : State)
+		{
+			Word = SplitMix64(Seed);
+		}
+	}
+
+	uint64_t FRandom::Next()
+	{
+		uint64_t Result = RotateLeft(State[1] * 5, 7) * 9;
+		uint64_t Shifted = State[1] << 17;
+
+		State[2] ^= State[0];
+		State[3] ^= State[1];
+		State[1] ^= State[2];
+		State[0] ^= State[3];
+		State[2] ^= Shifted;
+		State[3] = RotateLeft(State[3], 45);
+
+		return Result;
+	}
+
+	float FRandom::FRand()
+	{
+		return (Next() >> 40) * (1.0f / 16777216.0f);
+	}
+
+	float FRandom::Gauss()
+	{
+		//Box-Muller, the second value is dropped to keep the stream position simple
+		float U1 = std::max(FRand(), 1e-7f);
+		float U2 = FRand();
+
+		return std::sqrt(-2.0f * std::log(U1)) * std::cos(2.0f * Pi * U2);
+	}
+
+	FEngagementResult SimulateEngagement(const FWeaponStats& Weapon, const FSimSettings& Settings, float Distance, float ShooterSpeed, FRandom& Random)
+	{
+		FEngagementResult Result;
+
+		//ComputeVolleyAim: spread mapped from movement speed, the degrees / 360 value is used as the cone half angle in radians
+		float SpreadMultiplyer = std::min(std::max(ShooterSpeed / Settings.SpeedEqualToMaxSpread, 0.0f), 1.0f);
+		float ConeHalfAngle = Weapon.BaseSpreadInDegrees / 360.0f + ((Weapon.MaxSpreadInDegrees - Weapon.BaseSpreadInDegrees) / 360.0f) * SpreadMultiplyer;
+
+		float AimError = Settings.AimErrorDegrees * Pi / 180.0f;
+		float TimeBetweenShots = 60.0f / Weapon.RateOfFire;
+		bool bInRange = Distance <= Weapon.HitMaxDistance;
+
+		float HeadLine = Settings.TargetHalfHeight - Settings.HeadHeight;
+		float LegLine = -Settings.TargetHalfHeight + Settings.LegHeight;
+
+		float Health = Settings.TargetHealth;
+		float Time = 0;
+		int Bullets = Weapon.BulletsPerMagazine;
+		int Magazines = Weapon.DefaultMagazineCount;
+
+		while (true)
+		{
+			if (Bullets == 0)
+			{
+				if (Magazines == 0)
+				{
+					return Result;
+				}
+
+				Time += Weapon.ReloadTime;
+				Magazines--;
+				Bullets = Weapon.BulletsPerMagazine;
+				Result.Reloads++;
+			}
+
+			Bullets--;
+			Result.Shots++;
+
+			//One aim point per volley, every pellet shares it like the eyes view point in ComputeVolleyAim
+			float AimY = std::tan(Random.Gauss() * AimError);
+			float AimZ = std::tan(Random.Gauss() * AimError);
+
+			for (int Pellet = 0; Pellet < Weapon.PelletsPerShot; Pellet++)
+			{
+				float OffsetY = AimY;
+				float OffsetZ = AimZ;
+
+				if (ConeHalfAngle > 0)
+				{
+					//Same sampling as FMath::VRandCone, including the fmod that folds the polar angle into the cone
+					float Theta = 2.0f * Pi * Random.FRand();
+					float Phi = std::fmod(std::acos(2.0f * Random.FRand() - 1.0f), ConeHalfAngle);
+					float Deviation = std::tan(Phi);
+
+					OffsetY += Deviation * std::cos(Theta);
+					OffsetZ += Deviation * std::sin(Theta);
+				}
+
+				float HitY = OffsetY * Distance;
+				float HitZ = OffsetZ * Distance + Settings.AimHeight;
+
+				if (!bInRange || !HitsCapsule(HitY, HitZ, Settings.TargetRadius, Settings.TargetHalfHeight))
+				{
+					continue;
+				}
+
+				float Damage = Weapon.BaseDamage;
+
+				if (HitZ > HeadLine)
+				{
+					Damage *= Weapon.HeadshotMultiplyer;
+					Result.Headshots++;
+				}
+				else if (HitZ < LegLine)
+				{
+					Damage *= Weapon.WeakshotMultiplyer;
+				}
+
+				Health -= Damage;
+				Result.PelletsHit++;
+			}
+
+			if (Health <= 0)
+			{
+				Result.bKilled = true;
+				Result.TimeToKill = Time;
+				return Result;
+			}
+
+			Time += TimeBetweenShots;
+		}
+	}
+
+	std::vector<FTimeToKillStats> RunSweep(FWorkStealingPool& Pool, const FSimSettings& Settings, const std::vector<FWeaponStats>& Weapons, const std::vector<float>& Distances, const std::vector<float>& Speeds, uint64_t EngagementsPerCell)
+	{
+		struct FCell
+		{
+			const FWeaponStats* Weapon;
+
+			float Distance;
+
+			float Speed;
+
+			//Time to kill per engagement, negative when the target survived
+			std::vector<float> TimesToKill;
+
+			std::vector<FTaskTotals> TaskTotals;
+		};
+
+		uint64_t PerTask = std::max<uint64_t>(Settings.EngagementsPerTask, 1);
+		uint64_t TasksPerCell = (EngagementsPerCell + PerTask - 1) / PerTask;
+
+		std::vector<FCell> Cells;
+
+		for (const FWeaponStats& Weapon : Weapons)
+		{
+			for (float Distance : Distances)
+			{
+				for (float Speed : Speeds)
+				{
+					FCell Cell;
+					Cell.Weapon = &Weapon;
+					Cell.Distance = Distance;
+					Cell.Speed = Speed;
+					Cell.TimesToKill.resize(EngagementsPerCell);
+					Cell.TaskTotals.resize(TasksPerCell);
+					Cells.push_back(std::move(Cell));
+				}
+			}
+		}
+
+		std::vector<FWorkStealingPool::FTask> Tasks;
+		Tasks.reserve(Cells.size() * TasksPerCell);
+
+		for (size_t CellIndex = 0; CellIndex < Cells.size(); CellIndex++)
+		{
+			for (uint64_t TaskIndex = 0; TaskIndex < TasksPerCell; TaskIndex++)
+			{
+				Tasks.push_back([&Cells, &Settings, CellIndex, TaskIndex, PerTask, EngagementsPerCell]()
+				{
+					FCell& Cell = Cells[CellIndex];
+					FTaskTotals& Totals = Cell.TaskTotals[TaskIndex];
+
+					//Stream per task, seeded from its position in the sweep and not from the thread that runs it
+					uint64_t SeedState = Settings.Seed ^ (CellIndex * 0x100000001B3ull) ^ (TaskIndex << 32);
+					FRandom Random(SplitMix64(SeedState));
+
+					uint64_t Begin = TaskIndex * PerTask;
+					uint64_t End = std::min(Begin + PerTask, EngagementsPerCell);
+
+					for (uint64_t i = Begin; i < End; i++)
+					{
+						FEngagementResult Result = SimulateEngagement(*Cell.Weapon, Settings, Cell.Distance, Cell.Speed, Random);
+
+						Cell.TimesToKill[i] = Result.bKilled ? Result.TimeToKill : -1.0f;
+
+						Totals.Kills += Result.bKilled ? 1 : 0;
+						Totals.TimeToKillSum += Result.bKilled ? Result.TimeToKill : 0;
+						Totals.Shots += Result.Shots;
+						Totals.PelletsFired += (uint64_t)Result.Shots * Cell.Weapon->PelletsPerShot;
+						Totals.PelletsHit += Result.PelletsHit;
+						Totals.Headshots += Result.Headshots;
+						Totals.Reloads += Result.Reloads;
+					}
+				});
+			}
+		}
+
+		Pool.Run(Tasks);
+
+		std::vector<FTimeToKillStats> Stats;
+
+		for (FCell& Cell : Cells)
+		{
+			FTaskTotals Totals;
+
+			for (const FTaskTotals& Task : Cell.TaskTotals)
+			{
+				Totals.Kills += Task.Kills;
+				Totals.TimeToKillSum += Task.TimeToKillSum;
+				Totals.Shots += Task.Shots;
+				Totals.PelletsFired += Task.PelletsFired;
+				Totals.PelletsHit += Task.PelletsHit;
+				Totals.Headshots += Task.Headshots;
+				Totals.Reloads += Task.Reloads;
+			}
+
+			std::vector<float>& Kills = Cell.TimesToKill;
+			Kills.erase(std::remove_if(Kills.begin(), Kills.end(), [](float Time) { return Time < 0; }), Kills.end());
+			std::sort(Kills.begin(), Kills.end());
+
+			FTimeToKillStats CellStats;
+			CellStats.WeaponName = Cell.Weapon->Name;
+			CellStats.Distance = Cell.Distance;
+			CellStats.ShooterSpeed = Cell.Speed;
+			CellStats.Engagements = EngagementsPerCell;
+			CellStats.Kills = Totals.Kills;
+			CellStats.MeanTimeToKill = Totals.Kills > 0 ? Totals.TimeToKillSum / Totals.Kills : 0;
+			CellStats.P10 = Percentile(Kills, 0.10f);
+			CellStats.P50 = Percentile(Kills, 0.50f);
+			CellStats.P90 = Percentile(Kills, 0.90f);
+			CellStats.P99 = Percentile(Kills, 0.99f);
+			CellStats.MeanShots = EngagementsPerCell > 0 ? (double)Totals.Shots / EngagementsPerCell : 0;
+			CellStats.Accuracy = Totals.PelletsFired > 0 ? (double)Totals.PelletsHit / Totals.PelletsFired : 0;
+			CellStats.HeadshotRatio = Totals.PelletsHit > 0 ? (double)Totals.Headshots / Totals.PelletsHit : 0;
+			CellStats.MeanReloads = EngagementsPerCell > 0 ? (double)Totals.Reloads / EngagementsPerCell : 0;
+
+			Stats.push_back(CellStats);
+
+			//Per engagement results are only needed for the percentiles
+			std::vector<float>().swap(Cell.TimesToKill);
+		}
+
+		return Stats;
+	}
+}
@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "WeaponStats.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace WeaponBalanceSim
+{
+	class FWorkStealingPool;
+
+	//xoshiro256**, identical sequences on every platform and compiler unlike the std distributions
+	class FRandom
+	{
+	public:
+
+		explicit FRandom(uint64_t Seed);
+
+		uint64_t Next();
+
+		//[0, 1)
+		float FRand();
+
+		//Standard normal
+		float Gauss();
+
+	private:
+
+		uint64_t State[4];
+	};
+
+	struct FSimSettings
+	{
+		//ASWeapon::SpeedEqualToMaxSpread, movement speed at which spread reaches MaxSpreadInDegrees
+		float SpeedEqualToMaxSpread = 450;
+
+		//USHealthComponent::MaxHealth
+		float TargetHealth = 100;
+
+		//Default character capsule
+		float TargetRadius = 34;
+
+		float TargetHalfHeight = 88;
+
+		//Top of the capsule counted as SURFACE_FLESHVULNERABLE
+		float HeadHeight = 25;
+
+		//Bottom of the capsule counted as SURFACE_FLESHRESISTANT
+		float LegHeight = 70;
+
+		//Where the shooter aims, height above the capsule center. 0 is center mass, about 70 is the head
+	float AimHeight = 0;
+
+	//Standard deviation of the shooters aim around the aim point, per shot
+		float AimErrorDegrees = 0.5f;
+
+		uint64_t Seed = 1;
+
+		//Engagements per scheduled task, results do not depend on it or on the thread count
+		uint32_t EngagementsPerTask = 4096;
+	};
+
+	struct FEngagementResult
+	{
+		bool bKilled = false;
+
+		float TimeToKill = 0;
+
+		uint32_t Shots = 0;
+
+		uint32_t PelletsHit = 0;
+
+		uint32_t Headshots = 0;
+
+		uint32_t Reloads = 0;
+	};
+
+	struct FTimeToKillStats
+	{
+		std::string WeaponName;
+
+		float Distance = 0;
+
+		float ShooterSpeed = 0;
+
+		uint64_t Engagements = 0;
+
+		uint64_t Kills = 0;
+
+		//Over kills only, in seconds
+		double MeanTimeToKill = 0;
+
+		float P10 = 0;
+
+		float P50 = 0;
+
+		float P90 = 0;
+
+		float P99 = 0;
+
+		double MeanShots = 0;
+
+		//Pellets that hit over pellets fired
+		double Accuracy = 0;
+
+		//Headshots over pellets that hit
+		double HeadshotRatio = 0;
+
+		double MeanReloads = 0;
+	};
+
+	/**
+	 * Shooter standing at Distance from a character capsule, firing until it dies or ammo runs out. Spread follows
+	 * ASWeapon::ComputeVolleyAim and the cone sampling of FRandomStream::VRandCone, damage follows ApplyPelletDamage.
+	 */
+	FEngagementResult SimulateEngagement(const FWeaponStats& Weapon, const FSimSettings& Settings, float Distance, float ShooterSpeed, FRandom& Random);
+
+	//Every weapon at every distance and speed, EngagementsPerCell engagements each, spread over the pool
+	std::vector<FTimeToKillStats> RunSweep(FWorkStealingPool& Pool, const FSimSettings& Settings, const std::vector<FWeaponStats>& Weapons, const std::vector<float>& Distances, const std::vector<float>& Speeds, uint64_t EngagementsPerCell);
+}
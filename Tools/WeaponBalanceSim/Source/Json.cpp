@@ -0,0 +1,274 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Json.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace WeaponBalanceSim
+{
+	namespace
+	{
+		class FJsonParser
+		{
+		public:
+
+			explicit FJsonParser(const std::string& InText)
+				: Text(InText)
+			{
+			}
+
+			FJsonValue ParseDocument()
+			{
+				FJsonValue Value = ParseValue();
+				SkipWhitespace();
+
+				if (Pos != Text.size())
+				{
+					Fail("trailing characters");
+				}
+
+				return Value;
+			}
+
+		private:
+
+			const std::string& Text;
+
+			size_t Pos = 0;
+
+			[[noreturn]] void Fail(const char* Message) const
+			{
+				std::ostringstream Stream;
+				Stream << "JSON error at offset " << Pos << ": " << Message;
+				throw std::runtime_error(Stream.str());
+			}
+
+			void SkipWhitespace()
+			{
+				while (Pos < Text.size() && (Text[Pos] == ' ' || Text[Pos] == '\t' || Text[Pos] == '\n' || Text[Pos] == '\r'))
+				{
+					Pos++;
+				}
+			}
+
+			bool Consume(char Expected)
+			{
+				SkipWhitespace();
+
+				if (Pos < Text.size() && Text[Pos] == Expected)
+				{
+					Pos++;
+					return true;
+				}
+
+				return false;
+			}
+
+			void Expect(char Expected)
+			{
+				if (!Consume(Expected))
+				{
+					Fail("unexpected character");
+				}
+			}
+
+			void ExpectLiteral(const char* Literal)
+			{
+				for (const char* Char = Literal; *Char; Char++)
+				{
+					if (Pos >= Text.size() || Text[Pos] != *Char)
+					{
+						Fail("invalid literal");
+					}
+
+					Pos++;
+				}
+			}
+
+			FJsonValue ParseValue()
+			{
+				SkipWhitespace();
+
+				if (Pos >= Text.size())
+				{
+					Fail("unexpected end of input");
+				}
+
+				FJsonValue Value;
+				char Char = Text[Pos];
+
+				if (Char == '{')
+				{
+					Value.Type = FJsonValue::EType::Object;
+					Pos++;
+
+					if (Consume('}'))
+					{
+						return Value;
+					}
+
+					do
+					{
+						SkipWhitespace();
+						std::string Key = ParseString();
+						Expect(':');
+						Value.Object[Key] = ParseValue();
+					} while (Consume(','));
+
+					Expect('}');
+				}
+				else if (Char == '[')
+				{
+					Value.Type = FJsonValue::EType::Array;
+					Pos++;
+
+					if (Consume(']'))
+					{
+						return Value;
+					}
+
+					do
+					{
+						Value.Array.push_back(ParseValue());
+					} while (Consume(','));
+
+					Expect(']');
+				}
+				else if (Char == '"')
+				{
+					Value.Type = FJsonValue::EType::String;
+					Value.String = ParseString();
+				}
+				else if (Char == 't')
+				{
+					ExpectLiteral("true");
+					Value.Type = FJsonValue::EType::Bool;
+					Value.Bool = true;
+				}
+				else if (Char == 'f')
+				{
+					ExpectLiteral("false");
+					Value.Type = FJsonValue::EType::Bool;
+				}
+				else if (Char == 'n')
+				{
+					ExpectLiteral("null");
+				}
+				else
+				{
+					Value.Type = FJsonValue::EType::Number;
+					Value.Number = ParseNumber();
+				}
+
+				return Value;
+			}
+
+			std::string ParseString()
+			{
+				if (Pos >= Text.size() || Text[Pos] != '"')
+				{
+					Fail("expected string");
+				}
+
+				Pos++;
+				std::string Result;
+
+				while (Pos < Text.size() && Text[Pos] != '"')
+				{
+					char Char = Text[Pos++];
+
+					if (Char != '\\')
+					{
+						Result += Char;
+						continue;
+					}
+
+					if (Pos >= Text.size())
+					{
+						Fail("unterminated escape");
+					}
+
+					char Escaped = Text[Pos++];
+
+					switch (Escaped)
+					{
+					case 'n': Result += '\n'; break;
+					case 't': Result += '\t'; break;
+					case 'r': Result += '\r'; break;
+					case 'b': Result += '\b'; break;
+					case 'f': Result += '\f'; break;
+					case 'u':
+						//Exports only contain ASCII names, keep unknown code points as '?'
+						if (Pos + 4 > Text.size())
+						{
+							Fail("short unicode escape");
+						}
+
+						Pos += 4;
+						Result += '?';
+						break;
+					default: Result += Escaped; break;
+					}
+				}
+
+				if (Pos >= Text.size())
+				{
+					Fail("unterminated string");
+				}
+
+				Pos++;
+				return Result;
+			}
+
+			double ParseNumber()
+			{
+				const char* Start = Text.c_str() + Pos;
+				char* End = nullptr;
+				double Number = std::strtod(Start, &End);
+
+				if (End == Start)
+				{
+					Fail("expected value");
+				}
+
+				Pos += End - Start;
+				return Number;
+			}
+		};
+	}
+
+	const FJsonValue* FJsonValue::Find(const std::string& Key) const
+	{
+		if (Type != EType::Object)
+		{
+			return nullptr;
+		}
+
+		auto It = Object.find(Key);
+		return It != Object.end() ? &It->second : nullptr;
+	}
+
+	FJsonValue ParseJson(const std::string& Text)
+	{
+		FJsonParser Parser(Text);
+		return Parser.ParseDocument();
+	}
+
+	FJsonValue LoadJsonFile(const std::string& Path)
+	{
+		std::ifstream File(Path, std::ios::binary);
+
+		if (!File)
+		{
+			throw std::runtime_error("cannot open " + Path);
+		}
+
+		std::ostringstream Contents;
+		Contents << File.rdbuf();
+
+		return ParseJson(Contents.str());
+	}
+}
@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace WeaponBalanceSim
+{
+	//Just enough JSON for the DataTable exports in Content/Core
+	class FJsonValue
+	{
+	public:
+
+		enum class EType
+		{
+			Null,
+			Bool,
+			Number,
+			String,
+			Array,
+			Object
+		};
+
+		EType Type = EType::Null;
+
+		bool Bool = false;
+
+		double Number = 0;
+
+		std::string String;
+
+		std::vector<FJsonValue> Array;
+
+		std::map<std::string, FJsonValue> Object;
+
+		bool IsNumber() const { return Type == EType::Number; }
+
+		bool IsString() const { return Type == EType::String; }
+
+		//Member of an object, null if missing or not an object
+		const FJsonValue* Find(const std::string& Key) const;
+	};
+
+	//Throws std::runtime_error with the offset of the first error
+	FJsonValue ParseJson(const std::string& Text);
+
+	FJsonValue LoadJsonFile(const std::string& Path);
+}
@@ -0,0 +1,188 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EngagementSim.h"
+#include "WeaponStats.h"
+#include "WorkStealingPool.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace WeaponBalanceSim;
+
+namespace
+{
+	void PrintUsage()
+	{
+		std::printf(
+			"Usage: WeaponBalanceSim [options]\n"
+			"  --data <path>          DataTable JSON export (default Content/Core/WeaponsData.json)\n"
+			"  --engagements <n>      Engagements per weapon, distance and speed (default 1000000)\n"
+			"  --distances <a,b,...>  Shooter to target distances in cm (default 500,1500,3000,6000)\n"
+			"  --speeds <a,b,...>     Shooter movement speeds in cm/s (default 0,225,450)\n"
+			"  --aim-height <cm>      Aim point above the target center, ~70 aims at the head (default 0)\n"
+			"  --aim-error <deg>      Aim error standard deviation per shot (default 0.5)\n"
+			"  --max-spread-speed <v> SpeedEqualToMaxSpread of the weapons (default 450)\n"
+			"  --threads <n>          Worker threads, 0 for every hardware thread (default 0)\n"
+			"  --seed <n>             Random seed, same seed gives the same report (default 1)\n"
+			"  --csv                  Print CSV instead of a table\n");
+	}
+
+	std::vector<float> ParseList(const std::string& Text)
+	{
+		std::vector<float> Values;
+		std::stringstream Stream(Text);
+		std::string Item;
+
+		while (std::getline(Stream, Item, ','))
+		{
+			if (!Item.empty())
+			{
+				Values.push_back((float)std::atof(Item.c_str()));
+			}
+		}
+
+		return Values;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::string DataPath = "Content/Core/WeaponsData.json";
+	uint64_t Engagements = 1000000;
+	std::vector<float> Distances = { 500, 1500, 3000, 6000 };
+	std::vector<float> Speeds = { 0, 225, 450 };
+	unsigned Threads = 0;
+	bool bCsv = false;
+
+	FSimSettings Settings;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string Arg = argv[i];
+		bool bHasValue = i + 1 < argc;
+
+		if (Arg == "--help" || Arg == "-h")
+		{
+			PrintUsage();
+			return 0;
+		}
+		else if (Arg == "--csv")
+		{
+			bCsv = true;
+		}
+		else if (Arg == "--data" && bHasValue)
+		{
+			DataPath = argv[++i];
+		}
+		else if (Arg == "--engagements" && bHasValue)
+		{
+			Engagements = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (Arg == "--distances" && bHasValue)
+		{
+			Distances = ParseList(argv[++i]);
+		}
+		else if (Arg == "--speeds" && bHasValue)
+		{
+			Speeds = ParseList(argv[++i]);
+		}
+		else if (Arg == "--aim-height" && bHasValue)
+		{
+			Settings.AimHeight = (float)std::atof(argv[++i]);
+		}
+		else if (Arg == "--aim-error" && bHasValue)
+		{
+			Settings.AimErrorDegrees = (float)std::atof(argv[++i]);
+		}
+		else if (Arg == "--max-spread-speed" && bHasValue)
+		{
+			Settings.SpeedEqualToMaxSpread = (float)std::atof(argv[++i]);
+		}
+		else if (Arg == "--threads" && bHasValue)
+		{
+			Threads = (unsigned)std::atoi(argv[++i]);
+		}
+		else if (Arg == "--seed" && bHasValue)
+		{
+			Settings.Seed = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else
+		{
+			std::fprintf(stderr, "Unknown or incomplete option %s\n", Arg.c_str());
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	if (Distances.empty() || Speeds.empty() || Engagements == 0)
+	{
+		std::fprintf(stderr, "Need at least one distance, one speed and one engagement\n");
+		return 1;
+	}
+
+	std::vector<FWeaponStats> Weapons;
+	std::vector<FWeaponLoadReport> Reports;
+
+	try
+	{
+		Weapons = LoadWeaponStats(DataPath, GetDefaultWeaponStats(), Reports);
+	}
+	catch (const std::exception& Error)
+	{
+		std::fprintf(stderr, "%s\n", Error.what());
+		return 1;
+	}
+
+	for (const FWeaponLoadReport& Report : Reports)
+	{
+		std::string Fields;
+
+		for (const std::string& Field : Report.DefaultedFields)
+		{
+			Fields += (Fields.empty() ? "" : ", ") + Field;
+		}
+
+		std::fprintf(stderr, "%s: not in the export, using defaults for %s\n", Report.WeaponName.c_str(), Fields.c_str());
+	}
+
+	FWorkStealingPool Pool(Threads);
+
+	auto StartTime = std::chrono::steady_clock::now();
+	std::vector<FTimeToKillStats> Results = RunSweep(Pool, Settings, Weapons, Distances, Speeds, Engagements);
+	double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+
+	if (bCsv)
+	{
+		std::printf("Weapon,Distance,Speed,Engagements,KillRate,MeanTTK,P10,P50,P90,P99,MeanShots,Accuracy,HeadshotRatio,MeanReloads\n");
+	}
+	else
+	{
+		std::printf("%-12s %8s %6s %7s %8s %8s %8s %8s %8s %7s %6s %6s %7s\n", "Weapon", "Distance", "Speed", "Kill%", "MeanTTK", "P10", "P50", "P90", "P99", "Shots", "Acc%", "Head%", "Reloads");
+	}
+
+	for (const FTimeToKillStats& Stats : Results)
+	{
+		double KillRate = (double)Stats.Kills / Stats.Engagements;
+
+		if (bCsv)
+		{
+			std::printf("%s,%g,%g,%llu,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.3f,%.4f,%.4f,%.3f\n", Stats.WeaponName.c_str(), Stats.Distance, Stats.ShooterSpeed, (unsigned long long)Stats.Engagements,
+				KillRate, Stats.MeanTimeToKill, Stats.P10, Stats.P50, Stats.P90, Stats.P99, Stats.MeanShots, Stats.Accuracy, Stats.HeadshotRatio, Stats.MeanReloads);
+		}
+		else
+		{
+			std::printf("%-12s %8g %6g %6.1f%% %7.3fs %7.3fs %7.3fs %7.3fs %7.3fs %7.2f %5.1f%% %5.1f%% %7.2f\n", Stats.WeaponName.c_str(), Stats.Distance, Stats.ShooterSpeed,
+				KillRate * 100, Stats.MeanTimeToKill, Stats.P10, Stats.P50, Stats.P90, Stats.P99, Stats.MeanShots, Stats.Accuracy * 100, Stats.HeadshotRatio * 100, Stats.MeanReloads);
+		}
+	}
+
+	uint64_t Total = Engagements * Results.size();
+	std::fprintf(stderr, "%llu engagements in %.2fs on %u threads (%.1fM/s, %llu steals)\n", (unsigned long long)Total, Seconds, Pool.NumWorkers(), Total / Seconds / 1e6, (unsigned long long)Pool.GetStealCount());
+
+	return 0;
+}
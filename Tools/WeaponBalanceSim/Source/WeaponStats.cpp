@@ -0,0 +1,130 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WeaponStats.h"
+#include "Json.h"
+
+#include <stdexcept>
+
+namespace WeaponBalanceSim
+{
+	namespace
+	{
+		void ReadFloat(const FJsonValue& Row, const char* Field, float& InOutValue, FWeaponLoadReport& Report)
+		{
+			const FJsonValue* Value = Row.Find(Field);
+
+			if (Value && Value->IsNumber())
+			{
+				InOutValue = (float)Value->Number;
+			}
+			else
+			{
+				Report.DefaultedFields.push_back(Field);
+			}
+		}
+
+		void ReadInt(const FJsonValue& Row, const char* Field, int& InOutValue, FWeaponLoadReport& Report)
+		{
+			const FJsonValue* Value = Row.Find(Field);
+
+			if (Value && Value->IsNumber())
+			{
+				InOutValue = (int)Value->Number;
+			}
+			else
+			{
+				Report.DefaultedFields.push_back(Field);
+			}
+		}
+
+		void ReadString(const FJsonValue& Row, const char* Field, std::string& InOutValue)
+		{
+			const FJsonValue* Value = Row.Find(Field);
+
+			if (Value && Value->IsString())
+			{
+				InOutValue = Value->String;
+			}
+		}
+	}
+
+	FWeaponStats GetDefaultWeaponStats()
+	{
+		FWeaponStats Stats;
+		Stats.BaseDamage = 20;
+		Stats.RateOfFire = 300;
+		Stats.HitMaxDistance = 100000;
+		Stats.BulletsPerMagazine = 30;
+		Stats.DefaultMagazineCount = 4;
+		Stats.MaxSpreadInDegrees = 6;
+		Stats.BaseSpreadInDegrees = 1;
+		Stats.HeadshotMultiplyer = 2;
+		Stats.WeakshotMultiplyer = 0.75f;
+		Stats.ReloadTime = 2;
+		Stats.PelletsPerShot = 1;
+
+		return Stats;
+	}
+
+	std::vector<FWeaponStats> LoadWeaponStats(const std::string& Path, const FWeaponStats& Fallback, std::vector<FWeaponLoadReport>& OutReports)
+	{
+		FJsonValue Root = LoadJsonFile(Path);
+
+		if (Root.Type != FJsonValue::EType::Array)
+		{
+			throw std::runtime_error(Path + ": expected an array of weapon rows");
+		}
+
+		std::vector<FWeaponStats> Weapons;
+
+		for (const FJsonValue& Row : Root.Array)
+		{
+			FWeaponStats Stats = Fallback;
+			ReadString(Row, "Name", Stats.Name);
+
+			if (Stats.Name.empty())
+			{
+				throw std::runtime_error(Path + ": weapon row without a Name");
+			}
+
+			FWeaponLoadReport Report;
+			Report.WeaponName = Stats.Name;
+
+			ReadFloat(Row, "BaseDamage", Stats.BaseDamage, Report);
+			ReadString(Row, "DamageType", Stats.DamageType);
+			ReadFloat(Row, "RateOfFire", Stats.RateOfFire, Report);
+			ReadFloat(Row, "ThrowForce", Stats.ThrowForce, Report);
+			ReadFloat(Row, "HitMaxDistance", Stats.HitMaxDistance, Report);
+			ReadInt(Row, "BulletsPerMagazine", Stats.BulletsPerMagazine, Report);
+			ReadInt(Row, "DefaultMagazineCount", Stats.DefaultMagazineCount, Report);
+			ReadFloat(Row, "MaxSpreadInDegrees", Stats.MaxSpreadInDegrees, Report);
+			ReadFloat(Row, "HeadshotMultiplyer", Stats.HeadshotMultiplyer, Report);
+			ReadString(Row, "DisplayName", Stats.DisplayName);
+			ReadFloat(Row, "ReloadTime", Stats.ReloadTime, Report);
+			ReadFloat(Row, "BaseSpreadInDegrees", Stats.BaseSpreadInDegrees, Report);
+			ReadFloat(Row, "WeakshotMultiplyer", Stats.WeakshotMultiplyer, Report);
+
+			//Optional, only shotgun style rows carry it
+			const FJsonValue* Pellets = Row.Find("PelletsPerShot");
+
+			if (Pellets && Pellets->IsNumber())
+			{
+				Stats.PelletsPerShot = (int)Pellets->Number;
+			}
+
+			if (Stats.RateOfFire <= 0 || Stats.BulletsPerMagazine <= 0 || Stats.PelletsPerShot <= 0)
+			{
+				throw std::runtime_error(Path + ": " + Stats.Name + " needs a positive RateOfFire, BulletsPerMagazine and PelletsPerShot");
+			}
+
+			if (!Report.DefaultedFields.empty())
+			{
+				OutReports.push_back(Report);
+			}
+
+			Weapons.push_back(Stats);
+		}
+
+		return Weapons;
+	}
+}
@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace WeaponBalanceSim
+{
+	//Mirror of FWeaponData in Source/CoopLearning/Public/SWeapon.h, keep the field names in sync
+	struct FWeaponStats
+	{
+		std::string Name;
+
+		float BaseDamage = 0;
+
+		std::string DamageType;
+
+		float RateOfFire = 0;
+
+		float ThrowForce = 0;
+
+		float HitMaxDistance = 0;
+
+		int BulletsPerMagazine = 0;
+
+		int DefaultMagazineCount = 0;
+
+		float MaxSpreadInDegrees = 0;
+
+		float HeadshotMultiplyer = 1;
+
+		std::string DisplayName;
+
+		float ReloadTime = 0;
+
+		float BaseSpreadInDegrees = 0;
+
+		float WeakshotMultiplyer = 1;
+
+		//Not part of FWeaponData, ASShotgun sets it per class. Optional in the JSON
+		int PelletsPerShot = 1;
+	};
+
+	//Fields a row did not contain, filled from the fallback values
+	struct FWeaponLoadReport
+	{
+		std::string WeaponName;
+
+		std::vector<std::string> DefaultedFields;
+	};
+
+	/**
+	 * Reads a DataTable JSON export (array of rows keyed by "Name"). Missing fields fall back to the values of
+	 * Fallback so partial exports still simulate, every fallback is listed in OutReports.
+	 */
+	std::vector<FWeaponStats> LoadWeaponStats(const std::string& Path, const FWeaponStats& Fallback, std::vector<FWeaponLoadReport>& OutReports);
+
+	//Fallback for fields a partial export does not contain, close to the Rifle defaults
+	FWeaponStats GetDefaultWeaponStats();
+}
@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+
+namespace WeaponBalanceSim
+{
+	FWorkStealingPool::FWorkStealingPool(unsigned NumThreads)
+		: Queued(0)
+		, Pending(0)
+		, Steals(0)
+	{
+		if (NumThreads == 0)
+		{
+			NumThreads = std::max(1u, std::thread::hardware_concurrency());
+		}
+
+		for (unsigned i = 0; i < NumThreads; i++)
+		{
+			Queues.emplace_back(new FWorkerQueue());
+		}
+
+		for (unsigned i = 0; i < NumThreads; i++)
+		{
+			Threads.emplace_back(&FWorkStealingPool::WorkerLoop, this, i);
+		}
+	}
+
+	FWorkStealingPool::~FWorkStealingPool()
+	{
+		{
+			std::lock_guard<std::mutex> Lock(WakeMutex);
+			bStop = true;
+		}
+
+		WakeCondition.notify_all();
+
+		for (std::thread& Thread : Threads)
+		{
+			Thread.join();
+		}
+	}
+
+	void FWorkStealingPool::Run(std::vector<FTask>& Tasks)
+	{
+		if (Tasks.empty())
+		{
+			return;
+		}
+
+		//Round robin so every worker starts with local work, stealing only evens out the tail
+		for (size_t i = 0; i < Tasks.size(); i++)
+		{
+			FWorkerQueue& Queue = *Queues[i % Queues.size()];
+			std::lock_guard<std::mutex> Lock(Queue.Mutex);
+			Queue.Tasks.push_back(&Tasks[i]);
+		}
+
+		std::unique_lock<std::mutex> Lock(WakeMutex);
+		Pending = Tasks.size();
+		Queued = Tasks.size();
+		WakeCondition.notify_all();
+
+		DoneCondition.wait(Lock, [this]() { return Pending.load() == 0; });
+	}
+
+	FWorkStealingPool::FTask* FWorkStealingPool::PopLocal(unsigned Index)
+	{
+		FWorkerQueue& Queue = *Queues[Index];
+		std::lock_guard<std::mutex> Lock(Queue.Mutex);
+
+		if (Queue.Tasks.empty())
+		{
+			return nullptr;
+		}
+
+		FTask* Task = Queue.Tasks.back();
+		Queue.Tasks.pop_back();
+		return Task;
+	}
+
+	FWorkStealingPool::FTask* FWorkStealingPool::Steal(unsigned Thief)
+	{
+		for (size_t Offset = 1; Offset < Queues.size(); Offset++)
+		{
+			FWorkerQueue& Victim = *Queues[(Thief + Offset) % Queues.size()];
+			std::lock_guard<std::mutex> Lock(Victim.Mutex);
+
+			if (!Victim.Tasks.empty())
+			{
+				FTask* Task = Victim.Tasks.front();
+				Victim.Tasks.pop_front();
+				Steals++;
+				return Task;
+			}
+		}
+
+		return nullptr;
+	}
+
+	void FWorkStealingPool::WorkerLoop(unsigned Index)
+	{
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> Lock(WakeMutex);
+				WakeCondition.wait(Lock, [this]() { return bStop || Queued.load() > 0; });
+
+				if (bStop)
+				{
+					return;
+				}
+			}
+
+			while (Queued.load() > 0)
+			{
+				FTask* Task = PopLocal(Index);
+
+				if (!Task)
+				{
+					Task = Steal(Index);
+				}
+
+				if (!Task)
+				{
+					//Another worker took the last one between the check and the pop
+					std::this_thread::yield();
+					continue;
+				}
+
+				Queued--;
+				(*Task)();
+
+				if (--Pending == 0)
+				{
+					std::lock_guard<std::mutex> Lock(WakeMutex);
+					DoneCondition.notify_all();
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace WeaponBalanceSim
+{
+	/**
+	 * Fixed set of worker threads, each with its own task deque. A worker runs its own tasks newest first and,
+	 * once it runs dry, steals the oldest task of another worker, so uneven chunks still keep every core busy.
+	 */
+	class FWorkStealingPool
+	{
+	public:
+
+		typedef std::function<void()> FTask;
+
+		//0 uses every hardware thread
+		explicit FWorkStealingPool(unsigned NumThreads = 0);
+
+		~FWorkStealingPool();
+
+		FWorkStealingPool(const FWorkStealingPool&) = delete;
+
+		FWorkStealingPool& operator=(const FWorkStealingPool&) = delete;
+
+		//Runs every task and returns once all of them finished. Tasks must outlive the call
+		void Run(std::vector<FTask>& Tasks);
+
+		unsigned NumWorkers() const { return (unsigned)Threads.size(); }
+
+		uint64_t GetStealCount() const { return Steals.load(); }
+
+	private:
+
+		struct FWorkerQueue
+		{
+			std::mutex Mutex;
+
+			std::deque<FTask*> Tasks;
+		};
+
+		std::vector<std::unique_ptr<FWorkerQueue>> Queues;
+
+		std::vector<std::thread> Threads;
+
+		std::mutex WakeMutex;
+
+		std::condition_variable WakeCondition;
+
+		std::condition_variable DoneCondition;
+
+		//Tasks not picked up by any worker yet
+		std::atomic<size_t> Queued;
+
+		//Tasks not finished yet
+		std::atomic<size_t> Pending;
+
+		std::atomic<uint64_t> Steals;
+
+		bool bStop = false;
+
+		void WorkerLoop(unsigned Index);
+
+		FTask* PopLocal(unsigned Index);
+
+		FTask* Steal(unsigned Thief);
+	};
+}